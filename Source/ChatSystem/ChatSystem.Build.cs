@@ -52,5 +52,8 @@ public class ChatSystem : ModuleRules
 				// ... add any modules that your module loads dynamically here ...
 			}
 			);
+
+		// Defines UE_WITH_IRIS and adds IrisCore when the target replicates with Iris
+		SetupIrisSupport(Target);
 	}
 }
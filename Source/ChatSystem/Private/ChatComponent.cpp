@@ -2,16 +2,38 @@
 
 #include "ChatComponent.h"
 #include "ChatSubsystem.h"
+#include "ChatSystem.h"
+#include "Data/ChatMessageDataObject.h"
 #include "GameFramework/PlayerState.h"
+#include "GameFramework/PlayerController.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
 #include "Net/UnrealNetwork.h"
+#include "Algo/BinarySearch.h"
+
+namespace ChatComponentHistory
+{
+	/** Seconds between history request attempts while the owner is unknown */
+	constexpr float RequestRetryInterval = 0.25f;
+
+	/** Attempts before giving up, about ten seconds */
+	constexpr int32 MaxRequestRetries = 40;
+}
 
 UChatComponent::UChatComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
 	SetIsReplicatedByDefault(true);
-	LastMessageTime = 0.0f;
+	ReplicatedHistory.Owner = this;
+}
+
+void UChatComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// History is per recipient, so only the owning client needs it
+	DOREPLIFETIME_CONDITION(UChatComponent, HistorySessionId, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(UChatComponent, ReplicatedHistory, COND_OwnerOnly);
 }
 
 void UChatComponent::BeginPlay()
@@ -20,12 +42,94 @@ void UChatComponent::BeginPlay()
 	
 	// Cache the chat subsystem reference
 	ChatSubsystem = GetChatSubsystem();
+	MessageStore.SetCapacity(MaxStoredMessagesPerChannel);
 	
 	// Register with the subsystem
 	if (ChatSubsystem)
 	{
 		ChatSubsystem->RegisterChatComponent(this);
 	}
+
+	// The PlayerState often begins play before its owner has replicated, so keep asking for a while
+	if (GetNetMode() == NM_Client)
+	{
+		HistoryRequestRetriesLeft = ChatComponentHistory::MaxRequestRetries;
+		RequestMissedHistory();
+	}
+}
+
+void UChatComponent::RequestMissedHistory()
+{
+	if (bHistoryRequested || !ChatSubsystem || GetNetMode() != NM_Client)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	bool bKnown = false;
+	if (IsOwnedByLocalPlayer(bKnown))
+	{
+		// After a reconnect only entries newer than the last one we saw are sent
+		FGuid KnownSessionId;
+		int64 KnownSequence = 0;
+		ChatSubsystem->GetKnownHistory(KnownSessionId, KnownSequence);
+		ServerRequestHistory(KnownSessionId, KnownSequence);
+		bHistoryRequested = true;
+	}
+	else if (!bKnown && World && HistoryRequestRetriesLeft > 0)
+	{
+		--HistoryRequestRetriesLeft;
+		if (!World->GetTimerManager().IsTimerActive(HistoryRequestTimer))
+		{
+			World->GetTimerManager().SetTimer(HistoryRequestTimer, this, &UChatComponent::RequestMissedHistory, ChatComponentHistory::RequestRetryInterval, true);
+		}
+		return;
+	}
+
+	// Sent, another player's component, or out of retries
+	if (World)
+	{
+		World->GetTimerManager().ClearTimer(HistoryRequestTimer);
+	}
+}
+
+bool UChatComponent::IsOwnedByLocalPlayer(bool& bOutKnown) const
+{
+	const APlayerState* OwningPS = GetOwningPlayerState();
+	const APlayerController* OwningPC = OwningPS ? OwningPS->GetPlayerController() : nullptr;
+	if (OwningPC)
+	{
+		bOutKnown = true;
+		return OwningPC->IsLocalController();
+	}
+
+	// The local controller's PlayerState may replicate before the PlayerState's owner does
+	bOutKnown = false;
+	const UWorld* World = GetWorld();
+	if (!OwningPS || !World)
+	{
+		return false;
+	}
+
+	bool bAllLocalPlayerStatesKnown = true;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (!PC || !PC->IsLocalController())
+		{
+			continue;
+		}
+		if (PC->PlayerState == OwningPS)
+		{
+			bOutKnown = true;
+			return true;
+		}
+		bAllLocalPlayerStatesKnown &= PC->PlayerState != nullptr;
+	}
+
+	// Every local player already has another PlayerState, so this one belongs to a remote player
+	bOutKnown = bAllLocalPlayerStatesKnown && World->GetFirstPlayerController() != nullptr;
+	return false;
 }
 
 void UChatComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -39,7 +143,12 @@ void UChatComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	}
 	
 	// Clean up any references
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(HistoryRequestTimer);
+	}
 	ChatSubsystem = nullptr;
+	MessageObjectPool.Empty();
 }
 
 void UChatComponent::SendChatMessage(const FString& Content, EChatChannel Channel)
@@ -56,15 +165,15 @@ void UChatComponent::SendChatMessage(const FString& Content, EChatChannel Channe
 	}
 
 	// Validate locally first
-	FString FailureReason;
-	if (!ValidateMessageLocally(Content, FailureReason))
+	const EChatRejectReason RejectReason = ValidateMessageLocally(Content, Channel);
+	if (RejectReason != EChatRejectReason::None)
 	{
-		ClientNotifyMessageFailed(FailureReason);
+		ClientNotifyMessageRejected(RejectReason);
 		return;
 	}
 
 	// Send to server
-	ServerSendMessage(Content, Channel, nullptr);
+	ServerSendMessage(Content, Channel, nullptr, INDEX_NONE);
 }
 
 void UChatComponent::SendWhisper(APlayerState* TargetPlayer, const FString& Content)
@@ -81,15 +190,15 @@ void UChatComponent::SendWhisper(APlayerState* TargetPlayer, const FString& Cont
 	}
 
 	// Validate locally first
-	FString FailureReason;
-	if (!ValidateMessageLocally(Content, FailureReason))
+	const EChatRejectReason RejectReason = ValidateMessageLocally(Content, EChatChannel::Whisper);
+	if (RejectReason != EChatRejectReason::None)
 	{
-		ClientNotifyMessageFailed(FailureReason);
+		ClientNotifyMessageRejected(RejectReason);
 		return;
 	}
 
 	// Send to server with whisper target
-	ServerSendMessage(Content, EChatChannel::Whisper, TargetPlayer);
+	ServerSendMessage(Content, EChatChannel::Whisper, TargetPlayer, INDEX_NONE);
 }
 
 void UChatComponent::SendProximityMessage(const FString& Content)
@@ -106,46 +215,146 @@ void UChatComponent::SendProximityMessage(const FString& Content)
 	}
 
 	// Validate locally first
-	FString FailureReason;
-	if (!ValidateMessageLocally(Content, FailureReason))
+	const EChatRejectReason RejectReason = ValidateMessageLocally(Content, EChatChannel::Proximity);
+	if (RejectReason != EChatRejectReason::None)
 	{
-		ClientNotifyMessageFailed(FailureReason);
+		ClientNotifyMessageRejected(RejectReason);
 		return;
 	}
 
 	// Send to server
-	ServerSendMessage(Content, EChatChannel::Proximity, nullptr);
+	ServerSendMessage(Content, EChatChannel::Proximity, nullptr, INDEX_NONE);
+}
+
+void UChatComponent::SendChannelMessage(FName ChannelName, const FString& Content)
+{
+	if (Content.IsEmpty())
+	{
+		return;
+	}
+
+	const int32* ChannelId = JoinedChannels.Find(ChannelName);
+	if (!ChannelId)
+	{
+		ClientNotifyMessageRejected(EChatRejectReason::NotChannelMember);
+		return;
+	}
+
+	// Validate locally first
+	const EChatRejectReason RejectReason = ValidateMessageLocally(Content, EChatChannel::Custom);
+	if (RejectReason != EChatRejectReason::None)
+	{
+		ClientNotifyMessageRejected(RejectReason);
+		return;
+	}
+
+	// Send to server
+	ServerSendMessage(Content, EChatChannel::Custom, nullptr, *ChannelId);
+}
+
+void UChatComponent::JoinChannel(FName ChannelName)
+{
+	if (!ChannelName.IsNone() && !JoinedChannels.Contains(ChannelName))
+	{
+		ServerJoinChannel(ChannelName);
+	}
+}
+
+void UChatComponent::LeaveChannel(FName ChannelName)
+{
+	if (JoinedChannels.Contains(ChannelName))
+	{
+		ServerLeaveChannel(ChannelName);
+	}
+}
+
+void UChatComponent::ServerJoinChannel_Implementation(FName ChannelName)
+{
+	UChatSubsystem* Subsystem = GetChatSubsystem();
+	if (!Subsystem)
+	{
+		ClientNotifyMessageRejected(EChatRejectReason::SubsystemUnavailable);
+		return;
+	}
+
+	const EChatRejectReason RejectReason = Subsystem->RequestJoinChannel(GetOwningPlayerState(), ChannelName);
+	if (RejectReason != EChatRejectReason::None)
+	{
+		ClientNotifyMessageRejected(RejectReason);
+	}
+}
+
+void UChatComponent::ServerLeaveChannel_Implementation(FName ChannelName)
+{
+	if (UChatSubsystem* Subsystem = GetChatSubsystem())
+	{
+		Subsystem->RemovePlayerFromChannel(GetOwningPlayerState(), Subsystem->FindChannelId(ChannelName));
+	}
+}
+
+void UChatComponent::ClientNotifyChannelMembership_Implementation(int32 ChannelId, FName ChannelName, bool bJoined)
+{
+	if (bJoined)
+	{
+		JoinedChannels.Add(ChannelName, ChannelId);
+	}
+	else
+	{
+		JoinedChannels.Remove(ChannelName);
+	}
+
+	OnChannelMembershipChanged.Broadcast(ChannelName, bJoined);
+}
+
+void UChatComponent::SetChannelSubscription(int32 ChannelId, bool bSubscribed)
+{
+	if (ChannelId < 0)
+	{
+		return;
+	}
+
+	if (ChannelId >= ChannelSubscriptions.Num())
+	{
+		if (!bSubscribed)
+		{
+			return;
+		}
+		ChannelSubscriptions.Add(false, ChannelId + 1 - ChannelSubscriptions.Num());
+	}
+
+	ChannelSubscriptions[ChannelId] = bSubscribed;
 }
 
-void UChatComponent::ServerSendMessage_Implementation(const FString& Content, EChatChannel Channel, APlayerState* WhisperTarget)
+void UChatComponent::ServerSendMessage_Implementation(const FString& Content, EChatChannel Channel, APlayerState* WhisperTarget, int32 CustomChannelId)
 {
 	UChatSubsystem* Subsystem = GetChatSubsystem();
 	if (!Subsystem)
 	{
-		ClientNotifyMessageFailed(TEXT("Chat subsystem not available"));
+		ClientNotifyMessageRejected(EChatRejectReason::SubsystemUnavailable);
 		return;
 	}
 
 	APlayerState* OwningPS = GetOwningPlayerState();
 	if (!OwningPS)
 	{
-		ClientNotifyMessageFailed(TEXT("Invalid player state"));
+		ClientNotifyMessageRejected(EChatRejectReason::InvalidSender);
 		return;
 	}
 
 	// Create the message
 	FChatMessage Message(OwningPS, Content, Channel);
 	Message.WhisperTarget = WhisperTarget;
+	Message.CustomChannelId = Channel == EChatChannel::Custom ? CustomChannelId : INDEX_NONE;
 
 	// Let the subsystem handle validation and broadcasting
-	FString FailureReason;
-	if (!Subsystem->BroadcastMessage(Message, FailureReason))
+	const EChatRejectReason RejectReason = Subsystem->SubmitMessage(Message);
+	if (RejectReason != EChatRejectReason::None)
 	{
-		ClientNotifyMessageFailed(FailureReason);
+		ClientNotifyMessageRejected(RejectReason);
 	}
 }
 
-bool UChatComponent::ServerSendMessage_Validate(const FString& Content, EChatChannel Channel, APlayerState* WhisperTarget)
+bool UChatComponent::ServerSendMessage_Validate(const FString& Content, EChatChannel Channel, APlayerState* WhisperTarget, int32 CustomChannelId)
 {
 	// Basic validation to prevent malicious clients
 	return !Content.IsEmpty() && Content.Len() <= 1024;
@@ -153,6 +362,50 @@ bool UChatComponent::ServerSendMessage_Validate(const FString& Content, EChatCha
 
 void UChatComponent::ClientReceiveMessage_Implementation(const FChatMessage& Message)
 {
+	HandleReceivedMessage(Message);
+}
+
+void UChatComponent::ClientReceiveMessageBatch_Implementation(const TArray<FChatMessage>& Messages)
+{
+	for (const FChatMessage& Message : Messages)
+	{
+		HandleReceivedMessage(Message);
+	}
+}
+
+void UChatComponent::ClientReceiveMessageUnreliable_Implementation(const FChatMessage& Message)
+{
+	HandleReceivedMessage(Message);
+}
+
+void UChatComponent::ClientReceiveMessageBatchUnreliable_Implementation(const TArray<FChatMessage>& Messages)
+{
+	for (const FChatMessage& Message : Messages)
+	{
+		HandleReceivedMessage(Message);
+	}
+}
+
+void UChatComponent::HandleReceivedMessage(const FChatMessage& Message)
+{
+	// Drop messages that already arrived through another path (live delivery vs. history)
+	if (Message.SequenceId > 0)
+	{
+		const EChatSequenceResult SequenceResult = SequenceTrackers[static_cast<int32>(Message.Channel)].Accept(Message.SequenceId, FPlatformTime::Seconds());
+
+		// Stale ids are older than anything still remembered; copies never arrive that late, so they are shown
+		if (SequenceResult == EChatSequenceResult::Duplicate)
+		{
+			++NumDuplicateMessages;
+			return;
+		}
+
+		if (UChatSubsystem* Subsystem = GetChatSubsystem())
+		{
+			Subsystem->NoteReceivedSequence(HistorySessionId, Message.SequenceId);
+		}
+	}
+
 	// Check if sender is muted
 	if (Message.Sender && IsPlayerMuted(Message.Sender))
 	{
@@ -161,14 +414,108 @@ void UChatComponent::ClientReceiveMessage_Implementation(const FChatMessage& Mes
 
 	// Broadcast to local listeners (UI widgets)
 	OnChatMessageReceived.Broadcast(Message);
+
+	// Store it for virtualized lists; listeners hear about everything stored this frame in one broadcast
+	if (MaxStoredMessagesPerChannel > 0)
+	{
+		if (MessageStore.GetCapacity() != MaxStoredMessagesPerChannel)
+		{
+			MessageStore.SetCapacity(MaxStoredMessagesPerChannel);
+		}
+
+		MessageStore.Add(Message);
+
+		UWorld* World = GetWorld();
+		if (!bStoreChangesPending && World)
+		{
+			World->GetTimerManager().SetTimerForNextTick(this, &UChatComponent::BroadcastStoreChanges);
+			bStoreChangesPending = true;
+		}
+	}
+
+	// Only wrap messages in objects if someone displays them that way
+	if (MaxRetainedClientMessages > 0 && OnChatMessageObjectAdded.IsBound())
+	{
+		TArray<UChatMessageDataObject*> Evicted;
+		UChatMessageDataObject* MessageObject = MessageObjectPool.Add(this, Message, MaxRetainedClientMessages, Evicted);
+
+		// Removals go out first: the object just added may be one of them, rewrapped around the new message
+		for (UChatMessageDataObject* EvictedObject : Evicted)
+		{
+			OnChatMessageObjectRemoved.Broadcast(EvictedObject);
+		}
+		OnChatMessageObjectAdded.Broadcast(MessageObject);
+	}
 }
 
-void UChatComponent::ClientNotifyMessageFailed_Implementation(const FString& Reason)
+void UChatComponent::BroadcastStoreChanges()
 {
-	UE_LOG(LogTemp, Warning, TEXT("Chat message failed: %s"), *Reason);
-	
-	// You could broadcast this to UI as well if needed
-	// For now, just log it
+	bStoreChangesPending = false;
+
+	TArray<FChatStoreChange> Changes;
+	MessageStore.ConsumeChanges(Changes);
+	if (Changes.Num() > 0)
+	{
+		OnChatStoreChanged.Broadcast(Changes);
+	}
+}
+
+void UChatComponent::GetStoredMessageBounds(EChatChannel Channel, int64& OutFirstIndex, int64& OutEndIndex) const
+{
+	OutFirstIndex = MessageStore.GetFirstIndex(Channel);
+	OutEndIndex = MessageStore.GetEndIndex(Channel);
+}
+
+TArray<FChatMessage> UChatComponent::GetStoredMessages(EChatChannel Channel, int64 FirstIndex, int32 Count) const
+{
+	TArray<FChatMessage> Messages;
+	MessageStore.GetRange(Channel, FirstIndex, Count, Messages);
+	return Messages;
+}
+
+TArray<UChatMessageDataObject*> UChatComponent::GetRetainedMessageObjects() const
+{
+	return MessageObjectPool.GetRetained();
+}
+
+void UChatComponent::BeginHistoryReplication(const FGuid& SessionId, int64 EndSequence)
+{
+	HistorySessionId = SessionId;
+	HistorySyncEnd = EndSequence;
+}
+
+void UChatComponent::AddHistoryEntry(const FChatMessage& Message)
+{
+	ReplicatedHistory.AddEntry(Message);
+}
+
+void UChatComponent::ServerRequestHistory_Implementation(FGuid KnownSessionId, int64 AfterSequence)
+{
+	// One history sync per connection
+	UChatSubsystem* Subsystem = GetChatSubsystem();
+	if (Subsystem && HistorySyncEnd > 0)
+	{
+		Subsystem->RequestHistorySync(this, KnownSessionId, AfterSequence, HistorySyncEnd);
+		HistorySyncEnd = 0;
+	}
+}
+
+void UChatComponent::HandleHistoryMessage(const FChatMessage& Message)
+{
+	HandleReceivedMessage(Message);
+}
+
+void UChatComponent::HandleBroadcastMessage(const FChatMessage& Message)
+{
+	HandleReceivedMessage(Message);
+}
+
+void UChatComponent::ClientNotifyMessageRejected_Implementation(EChatRejectReason Reason)
+{
+	UE_LOG(LogChat, Warning, TEXT("Chat message failed: %s"), *UEnum::GetValueAsString(Reason));
+
+	// UI decides whether and how to turn the reason into text
+	OnChatMessageRejected.Broadcast(Reason);
 }
 
 void UChatComponent::MutePlayer(APlayerState* PlayerToMute)
@@ -181,6 +528,11 @@ void UChatComponent::MutePlayer(APlayerState* PlayerToMute)
 	if (!MutedPlayers.Contains(PlayerToMute))
 	{
 		MutedPlayers.Add(PlayerToMute);
+
+		if (bMirrorMutesToServer)
+		{
+			ServerSetPlayerMuted(PlayerToMute, true);
+		}
 	}
 }
 
@@ -191,7 +543,10 @@ void UChatComponent::UnmutePlayer(APlayerState* PlayerToUnmute)
 		return;
 	}
 
-	MutedPlayers.Remove(PlayerToUnmute);
+	if (MutedPlayers.Remove(PlayerToUnmute) > 0 && bMirrorMutesToServer)
+	{
+		ServerSetPlayerMuted(PlayerToUnmute, false);
+	}
 }
 
 bool UChatComponent::IsPlayerMuted(APlayerState* Player) const
@@ -202,6 +557,58 @@ bool UChatComponent::IsPlayerMuted(APlayerState* Player) const
 void UChatComponent::ClearMutedPlayers()
 {
 	MutedPlayers.Empty();
+
+	if (bMirrorMutesToServer)
+	{
+		ServerClearMutedPlayers();
+	}
+}
+
+bool UChatComponent::IsSenderMutedOnServer(int32 SenderKey) const
+{
+	return ServerMutedPlayerKeys.Num() > 0 && Algo::BinarySearch(ServerMutedPlayerKeys, SenderKey) != INDEX_NONE;
+}
+
+void UChatComponent::ServerSetPlayerMuted_Implementation(APlayerState* Player, bool bMuted)
+{
+	UChatSubsystem* Subsystem = GetChatSubsystem();
+	if (!Subsystem || !Player || Player == GetOwningPlayerState())
+	{
+		return;
+	}
+
+	// Players without a registered ChatComponent have no key and nothing to mute yet
+	const int32 PlayerKey = Subsystem->GetPlayerKey(Player);
+	if (PlayerKey == INDEX_NONE)
+	{
+		return;
+	}
+
+	const int32 InsertIndex = Algo::LowerBound(ServerMutedPlayerKeys, PlayerKey);
+	const bool bAlreadyMuted = ServerMutedPlayerKeys.IsValidIndex(InsertIndex) && ServerMutedPlayerKeys[InsertIndex] == PlayerKey;
+
+	if (bMuted && !bAlreadyMuted)
+	{
+		ServerMutedPlayerKeys.Insert(PlayerKey, InsertIndex);
+		Subsystem->AddServerMute(PlayerKey);
+	}
+	else if (!bMuted && bAlreadyMuted)
+	{
+		ServerMutedPlayerKeys.RemoveAt(InsertIndex);
+		Subsystem->RemoveServerMute(PlayerKey);
+	}
+}
+
+void UChatComponent::ServerClearMutedPlayers_Implementation()
+{
+	if (UChatSubsystem* Subsystem = GetChatSubsystem())
+	{
+		for (const int32 PlayerKey : ServerMutedPlayerKeys)
+		{
+			Subsystem->RemoveServerMute(PlayerKey);
+		}
+	}
+	ServerMutedPlayerKeys.Empty();
 }
 
 UChatSubsystem* UChatComponent::GetChatSubsystem()
@@ -232,13 +639,12 @@ APlayerState* UChatComponent::GetOwningPlayerState() const
 	return Cast<APlayerState>(GetOwner());
 }
 
-bool UChatComponent::ValidateMessageLocally(const FString& Content, FString& OutFailureReason)
+EChatRejectReason UChatComponent::ValidateMessageLocally(const FString& Content, EChatChannel Channel)
 {
 	// Check if message is empty
 	if (Content.IsEmpty())
 	{
-		OutFailureReason = TEXT("Message cannot be empty");
-		return false;
+		return EChatRejectReason::EmptyMessage;
 	}
 
 	// Check message length
@@ -249,24 +655,15 @@ bool UChatComponent::ValidateMessageLocally(const FString& Content, FString& Out
 		
 		if (Content.Len() > Settings.MaxMessageLength)
 		{
-			OutFailureReason = FString::Printf(TEXT("Message too long (max %d characters)"), Settings.MaxMessageLength);
-			return false;
+			return EChatRejectReason::MessageTooLong;
 		}
 
 		// Check rate limiting
-		const float CurrentTime = GetWorld()->GetTimeSeconds();
-		const float TimeSinceLastMessage = CurrentTime - LastMessageTime;
-		
-		if (TimeSinceLastMessage < Settings.MessageCooldown)
+		if (!LocalRateLimit.TryConsume(GetWorld()->GetTimeSeconds(), Channel, Settings))
 		{
-			OutFailureReason = FString::Printf(TEXT("Please wait %.1f seconds before sending another message"), 
-				Settings.MessageCooldown - TimeSinceLastMessage);
-			return false;
+			return EChatRejectReason::RateLimited;
 		}
-
-		// Update last message time
-		const_cast<UChatComponent*>(this)->LastMessageTime = CurrentTime;
 	}
 
-	return true;
+	return EChatRejectReason::None;
 }
@@ -0,0 +1,173 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ChatStats.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+DEFINE_STAT(STAT_ChatValidateMessage);
+DEFINE_STAT(STAT_ChatRouteMessage);
+DEFINE_STAT(STAT_ChatRunValidators);
+
+UE_TRACE_CHANNEL_DEFINE(ChatChannel);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Messages Submitted"), STAT_ChatMessagesSubmitted, STATGROUP_Chat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Messages Accepted"), STAT_ChatMessagesAccepted, STATGROUP_Chat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Messages Rejected"), STAT_ChatMessagesRejected, STATGROUP_Chat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Client RPCs"), STAT_ChatClientRPCs, STATGROUP_Chat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Messages Sent"), STAT_ChatMessagesSent, STATGROUP_Chat);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bytes Sent (estimated)"), STAT_ChatBytesSent, STATGROUP_Chat);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("History Messages"), STAT_ChatHistoryMessages, STATGROUP_Chat);
+
+TRACE_DECLARE_INT_COUNTER(ChatMessagesSubmitted, TEXT("Chat/Messages Submitted"));
+TRACE_DECLARE_INT_COUNTER(ChatMessagesAccepted, TEXT("Chat/Messages Accepted"));
+TRACE_DECLARE_INT_COUNTER(ChatMessagesRejected, TEXT("Chat/Messages Rejected"));
+TRACE_DECLARE_INT_COUNTER(ChatClientRPCs, TEXT("Chat/Client RPCs"));
+TRACE_DECLARE_INT_COUNTER(ChatMessagesSent, TEXT("Chat/Messages Sent"));
+TRACE_DECLARE_MEMORY_COUNTER(ChatBytesSent, TEXT("Chat/Bytes Sent (estimated)"));
+TRACE_DECLARE_INT_COUNTER(ChatHistoryMessages, TEXT("Chat/History Messages"));
+
+// One counter per reject reason and per channel fan-out
+#define CHAT_DECLARE_REJECT_STAT(Reason) \
+	DECLARE_DWORD_COUNTER_STAT(TEXT("Rejected: " #Reason), STAT_ChatRejected##Reason, STATGROUP_Chat); \
+	TRACE_DECLARE_INT_COUNTER(ChatRejected##Reason, TEXT("Chat/Rejected/" #Reason));
+
+#define CHAT_DECLARE_FANOUT_STAT(Channel) \
+	DECLARE_DWORD_COUNTER_STAT(TEXT("Recipients: " #Channel), STAT_ChatRecipients##Channel, STATGROUP_Chat); \
+	TRACE_DECLARE_INT_COUNTER(ChatFanOut##Channel, TEXT("Chat/Fan-out/" #Channel));
+
+CHAT_DECLARE_REJECT_STAT(NotServer)
+CHAT_DECLARE_REJECT_STAT(SubsystemUnavailable)
+CHAT_DECLARE_REJECT_STAT(InvalidSender)
+CHAT_DECLARE_REJECT_STAT(EmptyMessage)
+CHAT_DECLARE_REJECT_STAT(MessageTooLong)
+CHAT_DECLARE_REJECT_STAT(MissingWhisperTarget)
+CHAT_DECLARE_REJECT_STAT(RateLimited)
+CHAT_DECLARE_REJECT_STAT(ProfanityDetected)
+CHAT_DECLARE_REJECT_STAT(NotOnTeam)
+CHAT_DECLARE_REJECT_STAT(UnknownChannel)
+CHAT_DECLARE_REJECT_STAT(NotChannelMember)
+
+CHAT_DECLARE_FANOUT_STAT(Global)
+CHAT_DECLARE_FANOUT_STAT(Team)
+CHAT_DECLARE_FANOUT_STAT(Whisper)
+CHAT_DECLARE_FANOUT_STAT(System)
+CHAT_DECLARE_FANOUT_STAT(Proximity)
+CHAT_DECLARE_FANOUT_STAT(Custom)
+
+namespace ChatStats
+{
+	static bool IsTracing()
+	{
+		return UE_TRACE_CHANNELEXPR_IS_ENABLED(ChatChannel);
+	}
+
+	void RecordSubmitted()
+	{
+		INC_DWORD_STAT(STAT_ChatMessagesSubmitted);
+		if (IsTracing())
+		{
+			TRACE_COUNTER_INCREMENT(ChatMessagesSubmitted);
+		}
+	}
+
+	void RecordResult(EChatRejectReason Result)
+	{
+		const bool bTracing = IsTracing();
+		if (Result == EChatRejectReason::None)
+		{
+			INC_DWORD_STAT(STAT_ChatMessagesAccepted);
+			if (bTracing)
+			{
+				TRACE_COUNTER_INCREMENT(ChatMessagesAccepted);
+			}
+			return;
+		}
+
+		INC_DWORD_STAT(STAT_ChatMessagesRejected);
+		if (bTracing)
+		{
+			TRACE_COUNTER_INCREMENT(ChatMessagesRejected);
+		}
+
+#define CHAT_REJECT_CASE(Reason) \
+		case EChatRejectReason::Reason: \
+			INC_DWORD_STAT(STAT_ChatRejected##Reason); \
+			if (bTracing) \
+			{ \
+				TRACE_COUNTER_INCREMENT(ChatRejected##Reason); \
+			} \
+			break;
+
+		switch (Result)
+		{
+		CHAT_REJECT_CASE(NotServer)
+		CHAT_REJECT_CASE(SubsystemUnavailable)
+		CHAT_REJECT_CASE(InvalidSender)
+		CHAT_REJECT_CASE(EmptyMessage)
+		CHAT_REJECT_CASE(MessageTooLong)
+		CHAT_REJECT_CASE(MissingWhisperTarget)
+		CHAT_REJECT_CASE(RateLimited)
+		CHAT_REJECT_CASE(ProfanityDetected)
+		CHAT_REJECT_CASE(NotOnTeam)
+		CHAT_REJECT_CASE(UnknownChannel)
+		CHAT_REJECT_CASE(NotChannelMember)
+		default:
+			break;
+		}
+
+#undef CHAT_REJECT_CASE
+	}
+
+	void RecordFanOut(EChatChannel Channel, int32 NumRecipients)
+	{
+		const bool bTracing = IsTracing();
+
+		// Stats sum the recipients per frame, Insights shows each message's fan-out
+#define CHAT_FANOUT_CASE(Name) \
+		case EChatChannel::Name: \
+			INC_DWORD_STAT_BY(STAT_ChatRecipients##Name, NumRecipients); \
+			if (bTracing) \
+			{ \
+				TRACE_COUNTER_SET(ChatFanOut##Name, NumRecipients); \
+			} \
+			break;
+
+		switch (Channel)
+		{
+		CHAT_FANOUT_CASE(Global)
+		CHAT_FANOUT_CASE(Team)
+		CHAT_FANOUT_CASE(Whisper)
+		CHAT_FANOUT_CASE(System)
+		CHAT_FANOUT_CASE(Proximity)
+		CHAT_FANOUT_CASE(Custom)
+		default:
+			break;
+		}
+
+#undef CHAT_FANOUT_CASE
+	}
+
+	void RecordRpc(int32 NumMessages, int32 EstimatedBytes)
+	{
+		INC_DWORD_STAT(STAT_ChatClientRPCs);
+		INC_DWORD_STAT_BY(STAT_ChatMessagesSent, NumMessages);
+		INC_DWORD_STAT_BY(STAT_ChatBytesSent, EstimatedBytes);
+		if (IsTracing())
+		{
+			TRACE_COUNTER_INCREMENT(ChatClientRPCs);
+			TRACE_COUNTER_ADD(ChatMessagesSent, NumMessages);
+			TRACE_COUNTER_ADD(ChatBytesSent, EstimatedBytes);
+		}
+	}
+
+	void SetHistorySize(int32 NumMessages)
+	{
+		SET_DWORD_STAT(STAT_ChatHistoryMessages, NumMessages);
+		if (IsTracing())
+		{
+			TRACE_COUNTER_SET(ChatHistoryMessages, NumMessages);
+		}
+	}
+}
+
+#undef CHAT_DECLARE_REJECT_STAT
+#undef CHAT_DECLARE_FANOUT_STAT
@@ -0,0 +1,46 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Data/ChatMessage.h"
+
+DECLARE_STATS_GROUP(TEXT("Chat"), STATGROUP_Chat, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Validate Message"), STAT_ChatValidateMessage, STATGROUP_Chat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Route Message"), STAT_ChatRouteMessage, STATGROUP_Chat, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Run Validators"), STAT_ChatRunValidators, STATGROUP_Chat, );
+
+/** Insights channel for chat scopes and counters, enable with -trace=chat */
+UE_TRACE_CHANNEL_EXTERN(ChatChannel);
+
+/** Time a scope in "stat chat" and, while the Chat trace channel is enabled, in Insights */
+#define CHAT_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, ChatChannel)
+
+/**
+ * Chat load counters, feeding both "stat chat" and Insights
+ * Each call is a few increments; stats compile out of shipping builds and the trace counters are
+ * skipped unless the Chat trace channel is enabled
+ */
+namespace ChatStats
+{
+	/** A message was submitted on the server */
+	void RecordSubmitted();
+
+	/** A submitted message finished validation and moderation, with None meaning it was accepted */
+	void RecordResult(EChatRejectReason Result);
+
+	/** A routed message was handed to NumRecipients recipients */
+	void RecordFanOut(EChatChannel Channel, int32 NumRecipients);
+
+	/** A client RPC was issued carrying NumMessages messages of about EstimatedBytes */
+	void RecordRpc(int32 NumMessages, int32 EstimatedBytes);
+
+	/** The server history now holds NumMessages messages */
+	void SetHistorySize(int32 NumMessages);
+}
@@ -2,60 +2,254 @@
 
 #include "ChatSubsystem.h"
 #include "ChatComponent.h"
+#include "ChatSystem.h"
+#include "ChatStats.h"
 #include "GameFramework/PlayerState.h"
 #include "GameFramework/GameStateBase.h"
 #include "Engine/World.h"
+#include "Engine/GameInstance.h"
+#include "Engine/NetConnection.h"
+#include "Engine/ActorChannel.h"
+#include "Engine/NetDriver.h"
 #include "Kismet/GameplayStatics.h"
+#include "Filters/ChatProfanityFilter.h"
+#include "Persistence/ChatJournal.h"
+#include "Persistence/ChatArchive.h"
+#include "Routing/ChatReplicationInfo.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "Async/Async.h"
+#include "Interfaces/ChatTeamProvider.h"
+#include "GenericTeamAgentInterface.h"
+#if UE_WITH_IRIS
+#include "Iris/ReplicationSystem/ReplicationSystem.h"
+#include "Net/Iris/ReplicationSystem/ReplicationSystemUtil.h"
+#endif
 
 UChatSubsystem::UChatSubsystem()
 {
 	// Initialize default settings
 	ChatSettings = FChatSettings();
+	MessageHistory.SetCapacity(ChatSettings.MaxHistorySize);
+	RebuildValidatorChain();
 }
 
 void UChatSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
+
+	// Build the word filter up front so the first messages are already filtered
+	if (ChatSettings.bEnableProfanityFilter)
+	{
+		ProfanityFilter = FChatProfanityFilter::BuildFromFile(GetProfanityWordListFilePath());
+		if (!ProfanityFilter)
+		{
+			UE_LOG(LogChat, Warning, TEXT("Could not load profanity word list from %s"), *GetProfanityWordListFilePath());
+		}
+		RebuildValidatorChain();
+	}
+
+	HistorySessionId = FGuid::NewGuid();
 	
-	UE_LOG(LogTemp, Log, TEXT("ChatSubsystem initialized"));
+	UE_LOG(LogChat, Log, TEXT("ChatSubsystem initialized"));
 }
 
 void UChatSubsystem::Deinitialize()
 {
 	// Clean up
+	ModerationPipeline.Reset();
+	Journal.Reset(); // Writes whatever is still queued
+	bJournalInitialized = false;
+	PendingBatches.Empty();
+	if (IsValid(BroadcastRelay))
+	{
+		BroadcastRelay->Destroy();
+	}
+	BroadcastRelay = nullptr;
+	for (const TPair<int32, TObjectPtr<AChatReplicationInfo>>& Pair : TeamRelays)
+	{
+		if (IsValid(Pair.Value))
+		{
+			Pair.Value->Destroy();
+		}
+	}
+	TeamRelays.Empty();
+	bRelayCopiesPending = false;
+	OutboundQueues.Empty();
+	NumOutboundQueued = 0;
+	HistorySyncs.Empty();
 	RegisteredComponents.Empty();
+	RegisteredPlayerKeys.Empty();
+	ComponentIndexByPlayerKey.Empty();
+	PlayerKeyByPlayerState.Empty();
+	ServerMuteCounts.Empty();
+	SenderNameByPlayerKey.Empty();
+	TeamByPlayerKey.Empty();
+	TeamMemberKeys.Empty();
+	ChannelSlots.Empty();
+	FreeChannelIds.Empty();
+	ChannelIdByName.Empty();
 	MessageHistory.Empty();
-	PlayerMessageTimes.Empty();
+	SearchIndex.Empty();
+	RateLimitSlots.Empty();
+	UnindexedRateLimitSlots.Empty();
+	ProfanityFilter.Reset();
 	
 	Super::Deinitialize();
 }
 
+void UChatSubsystem::Tick(float DeltaTime)
+{
+	// Route messages that finished moderation since last tick
+	if (ModerationPipeline.HasPendingWork())
+	{
+		ModerationPipeline.ReleaseCompleted([this](FChatModerationJob& Job)
+		{
+			ReleaseModeratedMessage(Job);
+		});
+	}
+
+	if (HistorySyncs.Num() > 0)
+	{
+		PumpHistorySync();
+	}
+
+	if (NumOutboundQueued > 0)
+	{
+		DrainOutboundQueues(false);
+	}
+
+	TimeSinceLastFlush += DeltaTime;
+	if (TimeSinceLastFlush >= ChatSettings.BatchFlushInterval)
+	{
+		FlushPendingBatches();
+	}
+}
+
+ETickableTickType UChatSubsystem::GetTickableTickType() const
+{
+	// The CDO never ticks, live instances only tick while they have work to do
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UChatSubsystem::IsTickable() const
+{
+	return PendingBatches.Num() > 0 || bRelayCopiesPending || NumOutboundQueued > 0 || HistorySyncs.Num() > 0 || ModerationPipeline.HasPendingWork();
+}
+
+TStatId UChatSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UChatSubsystem, STATGROUP_Tickables);
+}
+
 bool UChatSubsystem::BroadcastMessage(const FChatMessage& Message, FString& OutFailureReason)
 {
-	UWorld* World = GetWorld();
-	if (!World)
+	// Blueprint callers expect the outcome now, so never defer to the moderation queue
+	const EChatRejectReason Result = SubmitMessage(Message, false);
+	if (Result != EChatRejectReason::None)
 	{
-		OutFailureReason = TEXT("Invalid world");
+		OutFailureReason = GetRejectReasonText(Result).ToString();
 		return false;
 	}
 
+	return true;
+}
+
+EChatRejectReason UChatSubsystem::SubmitMessage(const FChatMessage& Message, bool bAllowAsyncModeration)
+{
 	// Only server can broadcast messages
-	if (!World->GetAuthGameMode())
+	UWorld* World = GetWorld();
+	if (!World || !World->GetAuthGameMode())
 	{
-		OutFailureReason = TEXT("Only server can broadcast messages");
-		return false;
+		return EChatRejectReason::NotServer;
 	}
 
+	ChatStats::RecordSubmitted();
+
 	// Validate the message
-	if (!ValidateMessage(Message, OutFailureReason))
+	const EChatRejectReason ValidationResult = ValidateMessage(Message);
+	if (ValidationResult != EChatRejectReason::None)
 	{
-		return false;
+		ChatStats::RecordResult(ValidationResult);
+		return ValidationResult;
 	}
 
 	// Check rate limiting
-	if (Message.Sender && IsPlayerRateLimited(Message.Sender, OutFailureReason))
+	if (Message.Sender && !ConsumeRateLimitToken(Message.Sender, Message.Channel))
 	{
-		return false;
+		ChatStats::RecordResult(EChatRejectReason::RateLimited);
+		return EChatRejectReason::RateLimited;
+	}
+
+	// Expensive checks run off the game thread; the message is routed from Tick once they finish
+	const int32 SenderKey = GetPlayerKey(Message.Sender);
+	if (bAllowAsyncModeration && ChatSettings.bAsyncModeration && bValidatorChainRunsOffGameThread)
+	{
+		ModerationPipeline.Enqueue(Message, SenderKey, ValidatorChain);
+		return EChatRejectReason::None;
+	}
+
+	// Release anything this sender still has in flight first so its messages stay in order
+	if (ModerationPipeline.HasPendingWork(SenderKey))
+	{
+		FlushModerationQueue();
+	}
+
+	FChatModerationJob Job;
+	Job.Context.Message = Message;
+	Job.Sender = Message.Sender;
+	Job.WhisperTarget = Message.WhisperTarget;
+	Job.Validators = ValidatorChain;
+	ModerationPipeline.RunSynchronously(Job);
+
+	const EChatRejectReason Result = FinishModeration(Job);
+	ChatStats::RecordResult(Result);
+	return Result;
+}
+
+EChatRejectReason UChatSubsystem::FinishModeration(FChatModerationJob& Job)
+{
+	if (Job.Result != EChatRejectReason::None)
+	{
+		return Job.Result;
+	}
+
+	// Players may have left while the message was being moderated
+	if (Job.Sender.IsStale())
+	{
+		return EChatRejectReason::InvalidSender;
+	}
+	if (Job.WhisperTarget.IsStale())
+	{
+		return EChatRejectReason::MissingWhisperTarget;
+	}
+
+	FChatMessage& Message = Job.Context.Message;
+	Message.Sender = Job.Sender.Get();
+	Message.WhisperTarget = Job.WhisperTarget.Get();
+	const int32 SenderKey = GetPlayerKey(Message.Sender);
+	if (SenderKey != INDEX_NONE)
+	{
+		Message.bForceSenderName = NoteSenderName(SenderKey, Message.SenderName);
+	}
+
+	// Custom channels carry their registered color
+	if (Message.Channel == EChatChannel::Custom)
+	{
+		const FChatChannelSlot* ChannelSlot = FindChannelSlot(Message.CustomChannelId);
+		if (Message.CustomChannelId != INDEX_NONE && !ChannelSlot)
+		{
+			return EChatRejectReason::UnknownChannel;
+		}
+		if (ChannelSlot)
+		{
+			Message.MessageColor = ChannelSlot->Definition.Color;
+		}
+	}
+
+	if (Job.Context.bFlagged)
+	{
+		OnChatMessageFlagged.Broadcast(Message);
 	}
 
 	// Add to history
@@ -64,7 +258,40 @@ bool UChatSubsystem::BroadcastMessage(const FChatMessage& Message, FString& OutF
 	// Route the message based on channel
 	RouteMessage(Message);
 
-	return true;
+	return EChatRejectReason::None;
+}
+
+FText UChatSubsystem::GetRejectReasonText(EChatRejectReason Reason)
+{
+	switch (Reason)
+	{
+	case EChatRejectReason::None:
+		return FText::GetEmpty();
+	case EChatRejectReason::NotServer:
+		return NSLOCTEXT("ChatSystem", "RejectNotServer", "Only server can broadcast messages");
+	case EChatRejectReason::SubsystemUnavailable:
+		return NSLOCTEXT("ChatSystem", "RejectSubsystemUnavailable", "Chat subsystem not available");
+	case EChatRejectReason::InvalidSender:
+		return NSLOCTEXT("ChatSystem", "RejectInvalidSender", "Invalid sender");
+	case EChatRejectReason::EmptyMessage:
+		return NSLOCTEXT("ChatSystem", "RejectEmptyMessage", "Message cannot be empty");
+	case EChatRejectReason::MessageTooLong:
+		return NSLOCTEXT("ChatSystem", "RejectMessageTooLong", "Message too long");
+	case EChatRejectReason::MissingWhisperTarget:
+		return NSLOCTEXT("ChatSystem", "RejectMissingWhisperTarget", "Whisper requires a target player");
+	case EChatRejectReason::RateLimited:
+		return NSLOCTEXT("ChatSystem", "RejectRateLimited", "You are sending messages too quickly");
+	case EChatRejectReason::ProfanityDetected:
+		return NSLOCTEXT("ChatSystem", "RejectProfanityDetected", "Message contains inappropriate language");
+	case EChatRejectReason::NotOnTeam:
+		return NSLOCTEXT("ChatSystem", "RejectNotOnTeam", "You are not on a team");
+	case EChatRejectReason::UnknownChannel:
+		return NSLOCTEXT("ChatSystem", "RejectUnknownChannel", "That channel does not exist");
+	case EChatRejectReason::NotChannelMember:
+		return NSLOCTEXT("ChatSystem", "RejectNotChannelMember", "You can't post in that channel");
+	default:
+		return NSLOCTEXT("ChatSystem", "RejectUnknown", "Message could not be sent");
+	}
 }
 
 void UChatSubsystem::BroadcastSystemMessage(const FString& Content, FLinearColor Color)
@@ -77,7 +304,7 @@ void UChatSubsystem::BroadcastSystemMessage(const FString& Content, FLinearColor
 
 	FChatMessage SystemMessage;
 	SystemMessage.Sender = nullptr;
-	SystemMessage.SenderName = TEXT("System");
+	SystemMessage.SenderName = FChatMessage::SystemSenderName;
 	SystemMessage.Content = Content;
 	SystemMessage.Channel = EChatChannel::System;
 	SystemMessage.MessageColor = Color;
@@ -87,290 +314,1811 @@ void UChatSubsystem::BroadcastSystemMessage(const FString& Content, FLinearColor
 	AddToHistory(SystemMessage);
 
 	// Send to all players
-	SendToAllPlayers(SystemMessage);
+	RouteMessage(SystemMessage);
 }
 
 TArray<FChatMessage> UChatSubsystem::GetRecentMessages(int32 Count) const
 {
-	if (Count <= 0 || Count >= MessageHistory.Num())
-	{
-		return MessageHistory;
-	}
-
-	// Return the last N messages
+	// Return the last N messages (or everything if Count is 0)
 	TArray<FChatMessage> RecentMessages;
-	const int32 StartIndex = FMath::Max(0, MessageHistory.Num() - Count);
-	
-	for (int32 i = StartIndex; i < MessageHistory.Num(); ++i)
-	{
-		RecentMessages.Add(MessageHistory[i]);
-	}
-
+	MessageHistory.GetLast(Count, RecentMessages);
 	return RecentMessages;
 }
 
-void UChatSubsystem::ClearMessageHistory()
+TArray<FChatMessage> UChatSubsystem::QueryArchivedMessages(const FDateTime& From, const FDateTime& To, int32 MaxResults) const
 {
-	MessageHistory.Empty();
-}
+	TArray<FChatMessage> Messages;
+	if (!ChatSettings.bEnableJournal || MaxResults <= 0 || From >= To)
+	{
+		return Messages;
+	}
 
-void UChatSubsystem::SetChatSettings(const FChatSettings& NewSettings)
-{
-	UWorld* World = GetWorld();
-	if (!World || !World->GetAuthGameMode())
+	TArray<FString> ArchivePaths;
+	FChatArchive::FindArchives(GetJournalPath(), ArchivePaths);
+	for (const FString& ArchivePath : ArchivePaths)
 	{
-		return; // Only server can change settings
+		// Opening only maps the file; archives outside the range are skipped after reading their header
+		TUniquePtr<FChatArchive> Archive = FChatArchive::Open(ArchivePath);
+		if (Archive && Archive->GetMaxTimestamp() >= From && Archive->GetMinTimestamp() < To)
+		{
+			Archive->QueryByTime(From, To, MaxResults - Messages.Num(), Messages);
+			if (Messages.Num() >= MaxResults)
+			{
+				break;
+			}
+		}
 	}
 
-	ChatSettings = NewSettings;
+	return Messages;
 }
 
-void UChatSubsystem::RegisterChatComponent(UChatComponent* Component)
+TArray<FChatMessage> UChatSubsystem::SearchHistory(const FString& Query, EChatChannel Channel, int32 MaxResults, bool bAllChannels) const
 {
-	if (Component && !RegisteredComponents.Contains(Component))
+	TArray<int64> SequenceIds;
+	SearchIndex.Search(Query, MaxResults, [this, Channel, bAllChannels](int64 SequenceId)
+	{
+		const FChatMessage* Message = MessageHistory.FindBySequence(SequenceId);
+		return Message && (bAllChannels || Message->Channel == Channel);
+	}, SequenceIds);
+
+	TArray<FChatMessage> Messages;
+	Messages.Reserve(SequenceIds.Num());
+	for (const int64 SequenceId : SequenceIds)
 	{
-		RegisteredComponents.Add(Component);
-		UE_LOG(LogTemp, Log, TEXT("ChatComponent registered. Total: %d"), RegisteredComponents.Num());
+		Messages.Add(*MessageHistory.FindBySequence(SequenceId));
 	}
+	return Messages;
 }
 
-void UChatSubsystem::UnregisterChatComponent(UChatComponent* Component)
+void UChatSubsystem::RebuildSearchIndex()
 {
-	if (Component)
+	SearchIndex.Empty();
+	for (int32 i = 0; i < MessageHistory.Num(); ++i)
 	{
-		RegisteredComponents.Remove(Component);
-		
-		// Clean up player message times if this was their component
-		APlayerState* PS = Cast<APlayerState>(Component->GetOwner());
-		if (PS)
-		{
-			PlayerMessageTimes.Remove(PS);
-		}
-		
-		UE_LOG(LogTemp, Log, TEXT("ChatComponent unregistered. Total: %d"), RegisteredComponents.Num());
+		SearchIndex.Add(MessageHistory[i]);
 	}
 }
 
-bool UChatSubsystem::ValidateMessage(const FChatMessage& Message, FString& OutFailureReason)
+void UChatSubsystem::RequestHistorySync(UChatComponent* Component, const FGuid& KnownSessionId, int64 AfterSequence, int64 EndSequence)
 {
-	// Check if message content is valid
-	if (Message.Content.IsEmpty() && !ChatSettings.bAllowEmptyMessages)
+	if (!Component || !ChatSettings.bSyncHistoryToLateJoiners)
 	{
-		OutFailureReason = TEXT("Message content is empty");
-		return false;
+		return;
 	}
 
-	// Check message length
-	if (Message.Content.Len() > ChatSettings.MaxMessageLength)
+	// Sequence numbers from another server's history mean nothing here
+	const int64 RequestedStart = KnownSessionId == HistorySessionId ? AfterSequence + 1 : 0;
+	const int64 StartSequence = FMath::Max(RequestedStart, MessageHistory.GetFirstSequence());
+	if (StartSequence >= EndSequence)
 	{
-		OutFailureReason = FString::Printf(TEXT("Message too long (max %d characters)"), ChatSettings.MaxMessageLength);
-		return false;
+		return;
 	}
 
-	// Validate sender for non-system messages
-	if (Message.Channel != EChatChannel::System && !Message.Sender)
+	FChatHistorySync& Sync = HistorySyncs.AddDefaulted_GetRef();
+	Sync.Component = Component;
+	Sync.NextSequence = StartSequence;
+	Sync.EndSequence = EndSequence;
+}
+
+void UChatSubsystem::NoteReceivedSequence(const FGuid& SessionId, int64 Sequence)
+{
+	if (SessionId != KnownHistorySessionId)
 	{
-		OutFailureReason = TEXT("Invalid sender");
-		return false;
+		KnownHistorySessionId = SessionId;
+		KnownHistorySequence = 0;
 	}
 
-	// Validate whisper target
-	if (Message.Channel == EChatChannel::Whisper && !Message.WhisperTarget)
+	KnownHistorySequence = FMath::Max(KnownHistorySequence, Sequence);
+}
+
+void UChatSubsystem::PumpHistorySync()
+{
+	const int32 Budget = FMath::Max(1, ChatSettings.HistorySyncMessagesPerTick);
+
+	for (int32 i = HistorySyncs.Num() - 1; i >= 0; --i)
 	{
-		OutFailureReason = TEXT("Whisper requires a target player");
-		return false;
-	}
+		FChatHistorySync& Sync = HistorySyncs[i];
+		UChatComponent* Component = Sync.Component.Get();
 
-	return true;
+		// Entries evicted since the sync started are skipped
+		Sync.NextSequence = FMath::Max(Sync.NextSequence, MessageHistory.GetFirstSequence());
+
+		int32 NumQueued = 0;
+		while (Component && NumQueued < Budget && Sync.NextSequence < Sync.EndSequence)
+		{
+			const FChatMessage* Message = MessageHistory.FindBySequence(Sync.NextSequence);
+			if (Message && CanReceiveHistoryMessage(Component, *Message))
+			{
+				Component->AddHistoryEntry(*Message);
+				++NumQueued;
+			}
+			++Sync.NextSequence;
+		}
+
+		if (!Component || Sync.NextSequence >= Sync.EndSequence)
+		{
+			HistorySyncs.RemoveAtSwap(i, 1, EAllowShrinking::No);
+		}
+	}
 }
 
-void UChatSubsystem::RouteMessage(const FChatMessage& Message)
+bool UChatSubsystem::CanReceiveHistoryMessage(const UChatComponent* Recipient, const FChatMessage& Message) const
 {
+	const APlayerState* RecipientPS = Cast<APlayerState>(Recipient->GetOwner());
+	if (IsMutedOnServer(Recipient, Message.Sender))
+	{
+		return false;
+	}
+
 	switch (Message.Channel)
 	{
 	case EChatChannel::Global:
 	case EChatChannel::System:
-		SendToAllPlayers(Message);
-		break;
+		return true;
 
 	case EChatChannel::Team:
-		SendToTeam(Message);
-		break;
+	{
+		const int32* SenderTeam = TeamByPlayerKey.Find(GetPlayerKey(Message.Sender));
+		const int32* RecipientTeam = TeamByPlayerKey.Find(GetPlayerKey(RecipientPS));
+		return SenderTeam && RecipientTeam && *SenderTeam == *RecipientTeam;
+	}
 
 	case EChatChannel::Whisper:
-		SendToPlayer(Message);
-		break;
-
-	case EChatChannel::Proximity:
-		SendToProximity(Message);
-		break;
+		return RecipientPS && (Message.Sender == RecipientPS || Message.WhisperTarget == RecipientPS);
 
 	case EChatChannel::Custom:
-		// Custom channels can be handled by game-specific logic
-		SendToAllPlayers(Message);
-		break;
+		return Message.CustomChannelId == INDEX_NONE || Recipient->IsSubscribedToChannel(Message.CustomChannelId);
 
 	default:
-		SendToAllPlayers(Message);
-		break;
+		// Proximity depends on where players were when it was sent, which a late joiner never was
+		return false;
 	}
 }
 
-void UChatSubsystem::SendToAllPlayers(const FChatMessage& Message)
+void UChatSubsystem::ClearMessageHistory()
 {
-	for (UChatComponent* Component : RegisteredComponents)
-	{
-		if (Component && Component->GetOwner())
-		{
-			Component->ClientReceiveMessage(Message);
-		}
-	}
+	MessageHistory.Empty();
+	SearchIndex.Empty();
+	ChatStats::SetHistorySize(0);
 }
 
-void UChatSubsystem::SendToTeam(const FChatMessage& Message)
+void UChatSubsystem::SetChatSettings(const FChatSettings& NewSettings)
 {
-	if (!Message.Sender)
+	UWorld* World = GetWorld();
+	if (!World || !World->GetAuthGameMode())
 	{
-		return;
+		return; // Only server can change settings
 	}
 
-	// Team chat requires custom implementation in your PlayerState
-	// For now, send to all players as a fallback
-	// To implement team chat properly:
-	// 1. Add a TeamId property to your PlayerState (replicated)
-	// 2. Override this function in a custom ChatSubsystem subclass
-	// 3. Compare team IDs and only send to matching teams
-	
-	UE_LOG(LogTemp, Warning, TEXT("Team chat is not fully implemented. Override SendToTeam() in a custom ChatSubsystem to add team filtering. Sending to all players as fallback."));
-	SendToAllPlayers(Message);
-}
+	const bool bReloadProfanityFilter = NewSettings.bEnableProfanityFilter
+		&& (!ProfanityFilter || NewSettings.ProfanityWordListPath != ChatSettings.ProfanityWordListPath);
+	const bool bReopenJournal = NewSettings.bEnableJournal != ChatSettings.bEnableJournal
+		|| NewSettings.JournalPath != ChatSettings.JournalPath
+		|| NewSettings.JournalFlushInterval != ChatSettings.JournalFlushInterval
+		|| NewSettings.JournalSegmentSizeMB != ChatSettings.JournalSegmentSizeMB;
 
-void UChatSubsystem::SendToPlayer(const FChatMessage& Message)
-{
-	if (!Message.WhisperTarget)
+	ChatSettings = NewSettings;
+	if (MessageHistory.GetCapacity() != ChatSettings.MaxHistorySize)
 	{
-		return;
+		MessageHistory.SetCapacity(ChatSettings.MaxHistorySize);
+		RebuildSearchIndex();
 	}
+	RebuildValidatorChain();
 
-	// Send to the target player
-	UChatComponent* TargetComponent = GetChatComponentForPlayer(Message.WhisperTarget);
-	if (TargetComponent)
+	if (bReloadProfanityFilter)
 	{
-		TargetComponent->ClientReceiveMessage(Message);
+		ReloadProfanityFilter();
 	}
 
-	// Also send to the sender so they see their own whisper
-	if (Message.Sender)
+	// Closing writes whatever is still queued; an open journal is reopened right away with the new settings,
+	// otherwise it opens with the next message as usual
+	if (bReopenJournal && bJournalInitialized)
 	{
-		UChatComponent* SenderComponent = GetChatComponentForPlayer(Message.Sender);
-		if (SenderComponent)
-		{
-			SenderComponent->ClientReceiveMessage(Message);
-		}
+		Journal.Reset();
+		bJournalInitialized = false;
+		InitializeJournal();
 	}
-}
 
-void UChatSubsystem::SendToProximity(const FChatMessage& Message)
-{
-	if (!Message.Sender)
+	// Cell size follows the proximity radius, so force a rebuild on the next proximity send
+	LastProximityGridBuildTime = -1.0;
+
+	// Don't leave messages stranded in queues or batches once they are switched off
+	if (!ChatSettings.bEnableOutboundBudget && NumOutboundQueued > 0)
 	{
-		return;
+		DrainOutboundQueues(true);
 	}
-
-	// Get sender's pawn location
-	APawn* SenderPawn = Message.Sender->GetPawn();
-	if (!SenderPawn)
+	if (!ChatSettings.bEnableMessageBatching)
 	{
-		return;
+		FlushPendingBatches();
 	}
 
-	const FVector SenderLocation = SenderPawn->GetActorLocation();
-	const float RadiusSquared = ChatSettings.ProximityChatRadius * ChatSettings.ProximityChatRadius;
-
-	for (UChatComponent* Component : RegisteredComponents)
+	// Spawn the relays ahead of the first broadcast so clients already have them
+	if (ChatSettings.bUseBroadcastRelay)
 	{
-		if (!Component)
-		{
-			continue;
-		}
-
-		APlayerState* PS = Cast<APlayerState>(Component->GetOwner());
-		if (!PS)
-		{
-			continue;
-		}
-
-		APawn* Pawn = PS->GetPawn();
-		if (!Pawn)
-		{
-			continue;
-		}
-
-		// Check if within proximity range
-		const float DistanceSquared = FVector::DistSquared(SenderLocation, Pawn->GetActorLocation());
-		if (DistanceSquared <= RadiusSquared)
+		GetBroadcastRelay();
+		for (const TPair<int32, TArray<int32>>& Team : TeamMemberKeys)
 		{
-			Component->ClientReceiveMessage(Message);
+			GetTeamRelay(Team.Key);
 		}
 	}
 }
 
-UChatComponent* UChatSubsystem::GetChatComponentForPlayer(APlayerState* PlayerState) const
+void UChatSubsystem::ReloadProfanityFilter()
 {
-	if (!PlayerState)
-	{
-		return nullptr;
-	}
+	const FString FilePath = GetProfanityWordListFilePath();
+	TWeakObjectPtr<UChatSubsystem> WeakThis(this);
 
-	for (UChatComponent* Component : RegisteredComponents)
+	// Large word lists take a while to compile, so build off the game thread and swap when done
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [WeakThis, FilePath]()
 	{
-		if (Component && Component->GetOwner() == PlayerState)
+		TSharedPtr<const FChatProfanityFilter> NewFilter = FChatProfanityFilter::BuildFromFile(FilePath);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, FilePath, NewFilter]()
 		{
-			return Component;
-		}
-	}
+			UChatSubsystem* This = WeakThis.Get();
+			if (!This)
+			{
+				return;
+			}
 
-	return nullptr;
+			if (NewFilter)
+			{
+				This->ProfanityFilter = NewFilter;
+				This->RebuildValidatorChain();
+				UE_LOG(LogChat, Log, TEXT("Profanity filter loaded %d words from %s"), NewFilter->GetNumPatterns(), *FilePath);
+			}
+			else
+			{
+				UE_LOG(LogChat, Warning, TEXT("Could not load profanity word list from %s"), *FilePath);
+			}
+		});
+	});
 }
 
-void UChatSubsystem::AddToHistory(const FChatMessage& Message)
+void UChatSubsystem::SetProfanityWordList(const TArray<FString>& Words)
 {
-	MessageHistory.Add(Message);
+	ProfanityFilter = FChatProfanityFilter::Build(Words);
+	RebuildValidatorChain();
+}
 
-	// Trim history if it exceeds max size
-	while (MessageHistory.Num() > ChatSettings.MaxHistorySize)
-	{
-		MessageHistory.RemoveAt(0);
-	}
+void UChatSubsystem::AddMessageValidator(const TSharedRef<const IChatMessageValidator>& Validator)
+{
+	CustomValidators.AddUnique(Validator);
+	RebuildValidatorChain();
 }
 
-bool UChatSubsystem::IsPlayerRateLimited(APlayerState* PlayerState, FString& OutFailureReason)
+void UChatSubsystem::RemoveMessageValidator(const TSharedRef<const IChatMessageValidator>& Validator)
 {
-	if (!PlayerState)
+	CustomValidators.Remove(Validator);
+	RebuildValidatorChain();
+}
+
+void UChatSubsystem::FlushModerationQueue()
+{
+	ModerationPipeline.Flush([this](FChatModerationJob& Job)
+	{
+		ReleaseModeratedMessage(Job);
+	});
+}
+
+void UChatSubsystem::ReleaseModeratedMessage(FChatModerationJob& Job)
+{
+	const EChatRejectReason Result = FinishModeration(Job);
+	ChatStats::RecordResult(Result);
+	if (Result != EChatRejectReason::None)
+	{
+		if (UChatComponent* SenderComponent = GetChatComponentForPlayer(Job.Sender.Get()))
+		{
+			SenderComponent->ClientNotifyMessageRejected(Result);
+		}
+	}
+}
+
+void UChatSubsystem::RebuildValidatorChain()
+{
+	// In-flight jobs keep the chain they were enqueued with, so build a new one rather than editing in place
+	TSharedRef<FChatValidatorList> NewChain = MakeShared<FChatValidatorList>();
+
+	if (ChatSettings.bEnableProfanityFilter && ProfanityFilter)
+	{
+		NewChain->Add(MakeShared<FChatProfanityValidator>(ProfanityFilter.ToSharedRef(), ChatSettings.ProfanityFilterMode));
+	}
+	NewChain->Append(CustomValidators);
+
+	bValidatorChainRunsOffGameThread = NewChain->ContainsByPredicate([](const TSharedRef<const IChatMessageValidator>& Validator)
+	{
+		return Validator->RunsOffGameThread();
+	});
+	ValidatorChain = NewChain;
+}
+
+FString UChatSubsystem::GetProfanityWordListFilePath() const
+{
+	return FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), ChatSettings.ProfanityWordListPath);
+}
+
+void UChatSubsystem::RegisterChatComponent(UChatComponent* Component)
+{
+	if (!Component)
+	{
+		return;
+	}
+
+	APlayerState* PlayerState = Cast<APlayerState>(Component->GetOwner());
+	int32 PlayerKey = AssignPlayerKey(PlayerState);
+	if (const int32* ExistingIndex = ComponentIndexByPlayerKey.Find(PlayerKey))
+	{
+		const UChatComponent* Existing = RegisteredComponents[*ExistingIndex];
+		if (Existing == Component)
+		{
+			return;
+		}
+
+		if (IsValid(Existing) && Existing->GetOwner() == Component->GetOwner())
+		{
+			// A second live component on the same PlayerState; never evict the first, track this one unindexed
+			UE_LOG(LogChat, Warning, TEXT("%s already has a registered ChatComponent, %s is not indexed"), *GetNameSafe(Component->GetOwner()), *Component->GetName());
+			PlayerKey = INDEX_NONE;
+		}
+		else
+		{
+			// Destroyed or moved to another owner without unregistering, replace it
+			UE_LOG(LogChat, Warning, TEXT("Replacing stale ChatComponent registered for player %d"), PlayerKey);
+			RemoveRegisteredComponentAt(*ExistingIndex);
+			PlayerKey = AssignPlayerKey(PlayerState);
+		}
+	}
+
+	// Not owned by a PlayerState (or a duplicate), so it can't be indexed; fall back to the linear check
+	if (PlayerKey == INDEX_NONE && RegisteredComponents.Contains(Component))
+	{
+		return;
+	}
+
+	const int32 NewIndex = RegisteredComponents.Add(Component);
+	RegisteredPlayerKeys.Add(PlayerKey);
+	RateLimitSlots.AddDefaulted();
+	if (PlayerKey != INDEX_NONE)
+	{
+		ComponentIndexByPlayerKey.Add(PlayerKey, NewIndex);
+
+		// Carry over tokens spent before the component registered
+		FChatRateLimitSlot EarlySlot;
+		if (UnindexedRateLimitSlots.RemoveAndCopyValue(PlayerState, EarlySlot))
+		{
+			RateLimitSlots[NewIndex] = EarlySlot;
+		}
+		SetPlayerTeam(PlayerKey, QueryTeamId(PlayerState));
+	}
+
+	// Everything added to history from now on reaches this component live
+	if (Component->GetOwner() && Component->GetOwner()->HasAuthority())
+	{
+		InitializeJournal();
+		Component->BeginHistoryReplication(HistorySessionId, NextSequenceId);
+
+		if (ChatSettings.bUseBroadcastRelay)
+		{
+			GetBroadcastRelay();
+		}
+	}
+
+	checkSlow(IsComponentIndexConsistent());
+	LastProximityGridBuildTime = -1.0;
+	UE_LOG(LogChat, Log, TEXT("ChatComponent registered. Total: %d"), RegisteredComponents.Num());
+}
+
+void UChatSubsystem::UnregisterChatComponent(UChatComponent* Component)
+{
+	if (Component)
+	{
+		// Look the component up by its player key, falling back to a scan if the key changed since registration
+		int32 Index = INDEX_NONE;
+		const int32 PlayerKey = GetPlayerKey(Cast<APlayerState>(Component->GetOwner()));
+		if (const int32* IndexPtr = ComponentIndexByPlayerKey.Find(PlayerKey))
+		{
+			if (RegisteredComponents[*IndexPtr] == Component)
+			{
+				Index = *IndexPtr;
+			}
+		}
+
+		if (Index == INDEX_NONE)
+		{
+			Index = RegisteredComponents.Find(Component);
+		}
+
+		if (Index != INDEX_NONE)
+		{
+			RemoveRegisteredComponentAt(Index);
+		}
+
+		PendingBatches.Remove(Component);
+		if (const FChatOutboundQueue* Queue = OutboundQueues.Find(Component))
+		{
+			NumOutboundQueued -= Queue->Num();
+			OutboundQueues.Remove(Component);
+		}
+		LastProximityGridBuildTime = -1.0;
+		
+		checkSlow(IsComponentIndexConsistent());
+		UE_LOG(LogChat, Log, TEXT("ChatComponent unregistered. Total: %d"), RegisteredComponents.Num());
+	}
+}
+
+void UChatSubsystem::NotifyTeamChanged(APlayerState* PlayerState)
+{
+	const int32 PlayerKey = GetPlayerKey(PlayerState);
+	if (ComponentIndexByPlayerKey.Contains(PlayerKey))
+	{
+		SetPlayerTeam(PlayerKey, QueryTeamId(PlayerState));
+	}
+}
+
+int32 UChatSubsystem::GetPlayerTeamId(const APlayerState* PlayerState) const
+{
+	const int32* TeamId = TeamByPlayerKey.Find(GetPlayerKey(PlayerState));
+	return TeamId ? *TeamId : INDEX_NONE;
+}
+
+int32 UChatSubsystem::QueryTeamId(APlayerState* PlayerState)
+{
+	if (!PlayerState)
+	{
+		return INDEX_NONE;
+	}
+
+	if (PlayerState->Implements<UChatTeamProvider>())
+	{
+		return IChatTeamProvider::Execute_GetChatTeamId(PlayerState);
+	}
+
+	// Projects that already use the AI team system get team chat for free
+	if (const IGenericTeamAgentInterface* TeamAgent = Cast<IGenericTeamAgentInterface>(PlayerState))
+	{
+		const FGenericTeamId TeamId = TeamAgent->GetGenericTeamId();
+		return TeamId == FGenericTeamId::NoTeam ? INDEX_NONE : static_cast<int32>(TeamId.GetId());
+	}
+
+	return INDEX_NONE;
+}
+
+void UChatSubsystem::SetPlayerTeam(int32 PlayerKey, int32 NewTeamId)
+{
+	const int32* OldTeamId = TeamByPlayerKey.Find(PlayerKey);
+	if ((OldTeamId ? *OldTeamId : INDEX_NONE) == NewTeamId)
+	{
+		return;
+	}
+
+	if (OldTeamId)
+	{
+		if (TArray<int32>* OldMembers = TeamMemberKeys.Find(*OldTeamId))
+		{
+			OldMembers->RemoveSingleSwap(PlayerKey, EAllowShrinking::No);
+			if (OldMembers->Num() == 0)
+			{
+				TeamMemberKeys.Remove(*OldTeamId);
+			}
+		}
+
+		// An empty team's relay goes away with it
+		if (!TeamMemberKeys.Contains(*OldTeamId))
+		{
+			TObjectPtr<AChatReplicationInfo> OldRelay;
+			if (TeamRelays.RemoveAndCopyValue(*OldTeamId, OldRelay) && IsValid(OldRelay))
+			{
+				OldRelay->Destroy();
+			}
+		}
+		else
+		{
+			UpdateTeamRelayFilter(*OldTeamId);
+		}
+		TeamByPlayerKey.Remove(PlayerKey);
+	}
+
+	if (NewTeamId != INDEX_NONE)
+	{
+		TeamByPlayerKey.Add(PlayerKey, NewTeamId);
+		TeamMemberKeys.FindOrAdd(NewTeamId).Add(PlayerKey);
+
+		// Spawned ahead of the first team message so the member's client already has it
+		if (TeamRelays.Contains(NewTeamId))
+		{
+			UpdateTeamRelayFilter(NewTeamId);
+		}
+		else
+		{
+			GetTeamRelay(NewTeamId);
+		}
+	}
+}
+
+int32 UChatSubsystem::RegisterChannel(const FChatChannelDefinition& Definition)
+{
+	if (Definition.ChannelName.IsNone())
+	{
+		return INDEX_NONE;
+	}
+
+	if (const int32* ExistingId = ChannelIdByName.Find(Definition.ChannelName))
+	{
+		return *ExistingId;
+	}
+
+	const int32 ChannelId = FreeChannelIds.Num() > 0 ? FreeChannelIds.Pop(EAllowShrinking::No) : ChannelSlots.AddDefaulted();
+
+	FChatChannelSlot& ChannelSlot = ChannelSlots[ChannelId];
+	ChannelSlot.Definition = Definition;
+	ChannelSlot.Definition.ChannelId = ChannelId;
+	ChannelSlot.SubscriberKeys.Reset();
+	ChannelSlot.bActive = true;
+	ChannelIdByName.Add(Definition.ChannelName, ChannelId);
+
+	return ChannelId;
+}
+
+void UChatSubsystem::UnregisterChannel(int32 ChannelId)
+{
+	FChatChannelSlot* ChannelSlot = FindChannelSlot(ChannelId);
+	if (!ChannelSlot)
+	{
+		return;
+	}
+
+	// Clear every member's bit first so the id can be reused safely
+	for (const int32 SubscriberKey : ChannelSlot->SubscriberKeys)
+	{
+		if (const int32* Index = ComponentIndexByPlayerKey.Find(SubscriberKey))
+		{
+			UChatComponent* Component = RegisteredComponents[*Index];
+			Component->SetChannelSubscription(ChannelId, false);
+			Component->ClientNotifyChannelMembership(ChannelId, ChannelSlot->Definition.ChannelName, false);
+		}
+	}
+
+	ChannelIdByName.Remove(ChannelSlot->Definition.ChannelName);
+	ChannelSlot->SubscriberKeys.Empty();
+	ChannelSlot->bActive = false;
+	FreeChannelIds.Add(ChannelId);
+}
+
+int32 UChatSubsystem::FindChannelId(FName ChannelName) const
+{
+	const int32* ChannelId = ChannelIdByName.Find(ChannelName);
+	return ChannelId ? *ChannelId : INDEX_NONE;
+}
+
+bool UChatSubsystem::GetChannelDefinition(int32 ChannelId, FChatChannelDefinition& OutDefinition) const
+{
+	if (const FChatChannelSlot* ChannelSlot = FindChannelSlot(ChannelId))
+	{
+		OutDefinition = ChannelSlot->Definition;
+		return true;
+	}
+
+	return false;
+}
+
+bool UChatSubsystem::AddPlayerToChannel(APlayerState* PlayerState, int32 ChannelId)
+{
+	FChatChannelSlot* ChannelSlot = FindChannelSlot(ChannelId);
+	UChatComponent* Component = GetChatComponentForPlayer(PlayerState);
+	if (!ChannelSlot || !Component)
 	{
 		return false;
 	}
 
+	if (!Component->IsSubscribedToChannel(ChannelId))
+	{
+		Component->SetChannelSubscription(ChannelId, true);
+		ChannelSlot->SubscriberKeys.Add(GetPlayerKey(PlayerState));
+		Component->ClientNotifyChannelMembership(ChannelId, ChannelSlot->Definition.ChannelName, true);
+	}
+
+	return true;
+}
+
+void UChatSubsystem::RemovePlayerFromChannel(APlayerState* PlayerState, int32 ChannelId)
+{
+	FChatChannelSlot* ChannelSlot = FindChannelSlot(ChannelId);
+	UChatComponent* Component = GetChatComponentForPlayer(PlayerState);
+	if (!ChannelSlot || !Component || !Component->IsSubscribedToChannel(ChannelId))
+	{
+		return;
+	}
+
+	Component->SetChannelSubscription(ChannelId, false);
+	ChannelSlot->SubscriberKeys.RemoveSingleSwap(GetPlayerKey(PlayerState), EAllowShrinking::No);
+	Component->ClientNotifyChannelMembership(ChannelId, ChannelSlot->Definition.ChannelName, false);
+}
+
+EChatRejectReason UChatSubsystem::RequestJoinChannel(APlayerState* PlayerState, FName ChannelName)
+{
+	const int32 ChannelId = FindChannelId(ChannelName);
+	const FChatChannelSlot* ChannelSlot = FindChannelSlot(ChannelId);
+	if (!ChannelSlot)
+	{
+		return EChatRejectReason::UnknownChannel;
+	}
+
+	if (ChannelSlot->Definition.Policy != EChatChannelPolicy::Open)
+	{
+		return EChatRejectReason::NotChannelMember;
+	}
+
+	return AddPlayerToChannel(PlayerState, ChannelId) ? EChatRejectReason::None : EChatRejectReason::InvalidSender;
+}
+
+void UChatSubsystem::BroadcastChannelMessage(int32 ChannelId, const FString& Content)
+{
 	UWorld* World = GetWorld();
-	if (!World)
+	const FChatChannelSlot* ChannelSlot = FindChannelSlot(ChannelId);
+	if (!World || !World->GetAuthGameMode() || !ChannelSlot)
+	{
+		return; // Only server can send channel messages
+	}
+
+	FChatMessage ChannelMessage;
+	ChannelMessage.Sender = nullptr;
+	ChannelMessage.SenderName = FChatMessage::SystemSenderName;
+	ChannelMessage.Content = Content;
+	ChannelMessage.Channel = EChatChannel::Custom;
+	ChannelMessage.CustomChannelId = ChannelId;
+	ChannelMessage.MessageColor = ChannelSlot->Definition.Color;
+	ChannelMessage.Timestamp = FDateTime::Now();
+
+	// Add to history
+	AddToHistory(ChannelMessage);
+
+	// Send to channel members
+	RouteMessage(ChannelMessage);
+}
+
+UChatSubsystem::FChatChannelSlot* UChatSubsystem::FindChannelSlot(int32 ChannelId)
+{
+	return ChannelSlots.IsValidIndex(ChannelId) && ChannelSlots[ChannelId].bActive ? &ChannelSlots[ChannelId] : nullptr;
+}
+
+const UChatSubsystem::FChatChannelSlot* UChatSubsystem::FindChannelSlot(int32 ChannelId) const
+{
+	return ChannelSlots.IsValidIndex(ChannelId) && ChannelSlots[ChannelId].bActive ? &ChannelSlots[ChannelId] : nullptr;
+}
+
+void UChatSubsystem::RemoveFromAllChannels(UChatComponent* Component, int32 PlayerKey)
+{
+	if (!Component)
 	{
+		return;
+	}
+
+	for (TConstSetBitIterator<> It(Component->GetChannelSubscriptions()); It; ++It)
+	{
+		if (FChatChannelSlot* ChannelSlot = FindChannelSlot(It.GetIndex()))
+		{
+			ChannelSlot->SubscriberKeys.RemoveSingleSwap(PlayerKey, EAllowShrinking::No);
+		}
+	}
+}
+
+bool UChatSubsystem::NoteSenderName(int32 PlayerKey, const FString& SenderName)
+{
+	const UWorld* World = GetWorld();
+	const double Now = World ? World->GetTimeSeconds() : 0.0;
+
+	FChatSenderName& Entry = SenderNameByPlayerKey.FindOrAdd(PlayerKey);
+	if (Entry.Name.IsEmpty())
+	{
+		Entry.Name = SenderName;
 		return false;
 	}
 
-	const float CurrentTime = World->GetTimeSeconds();
-	
-	if (float* LastMessageTime = PlayerMessageTimes.Find(PlayerState))
+	if (!Entry.Name.Equals(SenderName, ESearchCase::CaseSensitive))
 	{
-		const float TimeSinceLastMessage = CurrentTime - *LastMessageTime;
-		
-		if (TimeSinceLastMessage < ChatSettings.MessageCooldown)
+		Entry.Name = SenderName;
+		Entry.RenameTime = Now;
+	}
+
+	return Entry.RenameTime >= 0.0 && Now - Entry.RenameTime < ChatSettings.SenderNameResendWindow;
+}
+
+int32 UChatSubsystem::GetPlayerKey(const APlayerState* PlayerState) const
+{
+	const int32* PlayerKey = PlayerState ? PlayerKeyByPlayerState.Find(PlayerState) : nullptr;
+	return PlayerKey ? *PlayerKey : INDEX_NONE;
+}
+
+int32 UChatSubsystem::AssignPlayerKey(const APlayerState* PlayerState)
+{
+	if (!PlayerState)
+	{
+		return INDEX_NONE;
+	}
+
+	int32& PlayerKey = PlayerKeyByPlayerState.FindOrAdd(PlayerState, INDEX_NONE);
+	if (PlayerKey == INDEX_NONE)
+	{
+		PlayerKey = NextPlayerKey++;
+	}
+	return PlayerKey;
+}
+
+void UChatSubsystem::AddServerMute(int32 PlayerKey)
+{
+	++ServerMuteCounts.FindOrAdd(PlayerKey);
+}
+
+void UChatSubsystem::RemoveServerMute(int32 PlayerKey)
+{
+	int32* Count = ServerMuteCounts.Find(PlayerKey);
+	if (Count && --(*Count) <= 0)
+	{
+		ServerMuteCounts.Remove(PlayerKey);
+	}
+}
+
+bool UChatSubsystem::IsMutedOnServer(const UChatComponent* Recipient, const APlayerState* Sender) const
+{
+	if (ServerMuteCounts.Num() == 0 || !Sender)
+	{
+		return false;
+	}
+
+	const int32 SenderKey = GetPlayerKey(Sender);
+	return ServerMuteCounts.Contains(SenderKey) && Recipient->IsSenderMutedOnServer(SenderKey);
+}
+
+void UChatSubsystem::RemoveRegisteredComponentAt(int32 Index)
+{
+	UChatComponent* Removed = RegisteredComponents[Index];
+	const int32 RemovedKey = RegisteredPlayerKeys[Index];
+	RemoveFromAllChannels(Removed, RemovedKey);
+	if (Removed)
+	{
+		for (const int32 MutedKey : Removed->GetServerMutedPlayerKeys())
 		{
-			OutFailureReason = FString::Printf(TEXT("Please wait %.1f seconds before sending another message"), ChatSettings.MessageCooldown - TimeSinceLastMessage);
-			return true;
+			RemoveServerMute(MutedKey);
 		}
 	}
 
-	// Update last message time
-	PlayerMessageTimes.Add(PlayerState, CurrentTime);
-	return false;
+	// Keys are never handed out again, so mutes other players hold on this one can't catch anyone else
+	// and are released along with those players
+	if (RemovedKey != INDEX_NONE)
+	{
+		ComponentIndexByPlayerKey.Remove(RemovedKey);
+		SenderNameByPlayerKey.Remove(RemovedKey);
+		SetPlayerTeam(RemovedKey, INDEX_NONE);
+		if (Removed)
+		{
+			PlayerKeyByPlayerState.Remove(Cast<APlayerState>(Removed->GetOwner()));
+		}
+	}
+
+	// Swap-remove keeps this O(1); the element moved into the hole needs its index fixed up
+	const int32 LastIndex = RegisteredComponents.Num() - 1;
+	RegisteredComponents.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	RegisteredPlayerKeys.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	RateLimitSlots.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	if (Index != LastIndex)
+	{
+		const int32 MovedKey = RegisteredPlayerKeys[Index];
+		if (MovedKey != INDEX_NONE)
+		{
+			ComponentIndexByPlayerKey.Add(MovedKey, Index);
+		}
+	}
+}
+
+bool UChatSubsystem::IsComponentIndexConsistent() const
+{
+	if (RegisteredComponents.Num() != RegisteredPlayerKeys.Num() || RegisteredComponents.Num() != RateLimitSlots.Num())
+	{
+		return false;
+	}
+
+	int32 NumKeyed = 0;
+	for (int32 i = 0; i < RegisteredPlayerKeys.Num(); ++i)
+	{
+		if (RegisteredPlayerKeys[i] != INDEX_NONE)
+		{
+			const int32* Index = ComponentIndexByPlayerKey.Find(RegisteredPlayerKeys[i]);
+			if (!Index || *Index != i)
+			{
+				return false;
+			}
+			++NumKeyed;
+		}
+	}
+
+	return NumKeyed == ComponentIndexByPlayerKey.Num();
+}
+
+EChatRejectReason UChatSubsystem::ValidateMessage(const FChatMessage& Message)
+{
+	CHAT_SCOPE_CYCLE_COUNTER(STAT_ChatValidateMessage);
+
+	// Check if message content is valid
+	if (Message.Content.IsEmpty() && !ChatSettings.bAllowEmptyMessages)
+	{
+		return EChatRejectReason::EmptyMessage;
+	}
+
+	// Check message length
+	if (Message.Content.Len() > ChatSettings.MaxMessageLength)
+	{
+		return EChatRejectReason::MessageTooLong;
+	}
+
+	// Validate sender for non-system messages
+	if (Message.Channel != EChatChannel::System && !Message.Sender)
+	{
+		return EChatRejectReason::InvalidSender;
+	}
+
+	// Validate whisper target
+	if (Message.Channel == EChatChannel::Whisper && !Message.WhisperTarget)
+	{
+		return EChatRejectReason::MissingWhisperTarget;
+	}
+
+	// Registered custom channels only accept posts from their members
+	if (Message.Channel == EChatChannel::Custom && Message.CustomChannelId != INDEX_NONE)
+	{
+		const FChatChannelSlot* ChannelSlot = FindChannelSlot(Message.CustomChannelId);
+		if (!ChannelSlot)
+		{
+			return EChatRejectReason::UnknownChannel;
+		}
+
+		if (Message.Sender)
+		{
+			const UChatComponent* SenderComponent = GetChatComponentForPlayer(Message.Sender);
+			if (ChannelSlot->Definition.Policy == EChatChannelPolicy::ReadOnly
+				|| !SenderComponent || !SenderComponent->IsSubscribedToChannel(Message.CustomChannelId))
+			{
+				return EChatRejectReason::NotChannelMember;
+			}
+		}
+	}
+
+	// Team chat needs a team to send to
+	if (Message.Channel == EChatChannel::Team && GetPlayerTeamId(Message.Sender) == INDEX_NONE)
+	{
+		return EChatRejectReason::NotOnTeam;
+	}
+
+	return EChatRejectReason::None;
+}
+
+void UChatSubsystem::RouteMessage(const FChatMessage& Message)
+{
+	CHAT_SCOPE_CYCLE_COUNTER(STAT_ChatRouteMessage);
+	const int32 DeliveriesBefore = NumDeliveries;
+
+	switch (Message.Channel)
+	{
+	case EChatChannel::Global:
+	case EChatChannel::System:
+		SendToAllPlayers(Message);
+		break;
+
+	case EChatChannel::Team:
+		SendToTeam(Message);
+		break;
+
+	case EChatChannel::Whisper:
+		SendToPlayer(Message);
+		break;
+
+	case EChatChannel::Proximity:
+		SendToProximity(Message);
+		break;
+
+	case EChatChannel::Custom:
+		// Registered channels go to their members; unregistered Custom messages keep the old broadcast behavior
+		if (Message.CustomChannelId != INDEX_NONE)
+		{
+			SendToChannel(Message);
+		}
+		else
+		{
+			SendToAllPlayers(Message);
+		}
+		break;
+
+	default:
+		SendToAllPlayers(Message);
+		break;
+	}
+
+	ChatStats::RecordFanOut(Message.Channel, NumDeliveries - DeliveriesBefore);
+}
+
+void UChatSubsystem::SendToAllPlayers(const FChatMessage& Message)
+{
+	if (SendThroughRelay(Message))
+	{
+		return;
+	}
+
+	for (UChatComponent* Component : RegisteredComponents)
+	{
+		if (Component && Component->GetOwner())
+		{
+			DeliverMessage(Component, Message);
+		}
+	}
+}
+
+bool UChatSubsystem::SendThroughRelay(const FChatMessage& Message)
+{
+	// Per-recipient queues can't be honored by a single multicast
+	if (!ChatSettings.bUseBroadcastRelay || ChatSettings.bEnableOutboundBudget
+		|| (Message.Channel != EChatChannel::Global && Message.Channel != EChatChannel::System))
+	{
+		return false;
+	}
+
+	AChatReplicationInfo* Relay = GetBroadcastRelay();
+	if (!Relay)
+	{
+		return false;
+	}
+
+	MulticastThroughRelay(Relay, Message);
+
+	// Fan-out stats still count every player the multicast reaches
+	NumDeliveries += RegisteredComponents.Num();
+	return true;
+}
+
+void UChatSubsystem::MulticastThroughRelay(AChatReplicationInfo* Relay, const FChatMessage& Message)
+{
+	// The name can't be dropped per connection when the bits are shared by every connection
+	FChatMessage SharedMessage = Message;
+	SharedMessage.bForceSenderName = true;
+
+	switch (ChatSettings.GetDeliveryPolicy(SharedMessage.Channel))
+	{
+	case EChatDeliveryPolicy::Unreliable:
+		Relay->MulticastReceiveMessageUnreliable(SharedMessage);
+		break;
+
+	case EChatDeliveryPolicy::UnreliableRedundant:
+		Relay->MulticastReceiveMessageUnreliable(SharedMessage);
+		Relay->RedundantCopies.Add(SharedMessage);
+		bRelayCopiesPending = true;
+		break;
+
+	default:
+		Relay->MulticastReceiveMessage(SharedMessage);
+		break;
+	}
+
+	++BatchingStats.RelayMulticastsSent;
+	ChatStats::RecordRpc(1, FChatOutboundQueue::EstimateWireSize(SharedMessage));
+}
+
+AChatReplicationInfo* UChatSubsystem::GetBroadcastRelay()
+{
+	UWorld* World = GetWorld();
+	if (!World || World->GetNetMode() == NM_Client)
+	{
+		return nullptr;
+	}
+
+	// The relay belongs to one world, a travel leaves it behind
+	if (!IsValid(BroadcastRelay) || BroadcastRelay->GetWorld() != World)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		BroadcastRelay = World->SpawnActor<AChatReplicationInfo>(SpawnParams);
+	}
+	return BroadcastRelay;
+}
+
+bool UChatSubsystem::SendThroughTeamRelay(const FChatMessage& Message, int32 TeamId)
+{
+	AChatReplicationInfo* Relay = ChatSettings.bEnableOutboundBudget ? nullptr : GetTeamRelay(TeamId);
+	const TArray<int32>* Members = TeamMemberKeys.Find(TeamId);
+
+	// An unfiltered relay reaches every client, so without a filter the members are sent to one by one
+	if (!Relay || !Members || (!Relay->bTeamFilterApplied && !UpdateTeamRelayFilter(TeamId)))
+	{
+		return false;
+	}
+
+	MulticastThroughRelay(Relay, Message);
+
+	// The relay skips members playing on the server itself, they have no connection to filter on
+	for (const int32 MemberKey : *Members)
+	{
+		if (const int32* Index = ComponentIndexByPlayerKey.Find(MemberKey))
+		{
+			UChatComponent* Component = RegisteredComponents[*Index];
+			AActor* Owner = Component ? Component->GetOwner() : nullptr;
+			if (Owner && !Owner->GetNetConnection())
+			{
+				DeliverMessage(Component, Message);
+			}
+			else if (Owner)
+			{
+				++NumDeliveries;
+			}
+		}
+	}
+	return true;
+}
+
+AChatReplicationInfo* UChatSubsystem::GetTeamRelay(int32 TeamId)
+{
+#if UE_WITH_IRIS
+	UWorld* World = GetWorld();
+	const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+	if (!ChatSettings.bUseBroadcastRelay || !NetDriver || !NetDriver->IsServer() || !NetDriver->IsUsingIrisReplication())
+	{
+		return nullptr;
+	}
+
+	TObjectPtr<AChatReplicationInfo>& Relay = TeamRelays.FindOrAdd(TeamId);
+	if (!IsValid(Relay) || Relay->GetWorld() != World)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		Relay = World->SpawnActor<AChatReplicationInfo>(SpawnParams);
+		if (!Relay)
+		{
+			TeamRelays.Remove(TeamId);
+			return nullptr;
+		}
+
+		Relay->TeamId = TeamId;
+		UpdateTeamRelayFilter(TeamId);
+	}
+	return Relay;
+#else
+	return nullptr;
+#endif
+}
+
+bool UChatSubsystem::UpdateTeamRelayFilter(int32 TeamId)
+{
+#if UE_WITH_IRIS
+	const TObjectPtr<AChatReplicationInfo>* Relay = TeamRelays.Find(TeamId);
+	if (!Relay || !IsValid(*Relay))
+	{
+		return false;
+	}
+
+	// The old filter no longer matches the members, whatever happens below
+	AChatReplicationInfo* TeamRelay = *Relay;
+	TeamRelay->bTeamFilterApplied = false;
+
+	UWorld* World = GetWorld();
+	UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+	UReplicationSystem* ReplicationSystem = NetDriver ? NetDriver->GetReplicationSystem() : nullptr;
+	if (!ReplicationSystem)
+	{
+		return false;
+	}
+
+	const UE::Net::FNetRefHandle RelayHandle = UE::Net::FReplicationSystemUtil::GetNetRefHandle(TeamRelay);
+	if (!RelayHandle.IsValid())
+	{
+		return false;
+	}
+
+	// Iris connection ids index the bit array
+	TBitArray<> Connections;
+	if (const TArray<int32>* Members = TeamMemberKeys.Find(TeamId))
+	{
+		for (const int32 MemberKey : *Members)
+		{
+			const int32* Index = ComponentIndexByPlayerKey.Find(MemberKey);
+			const UChatComponent* Component = Index ? RegisteredComponents[*Index].Get() : nullptr;
+			const AActor* Owner = Component ? Component->GetOwner() : nullptr;
+			const UNetConnection* Connection = Owner ? Owner->GetNetConnection() : nullptr;
+			if (!Connection)
+			{
+				continue;
+			}
+
+			const int32 ConnectionId = static_cast<int32>(Connection->GetConnectionId());
+			if (ConnectionId >= Connections.Num())
+			{
+				Connections.Add(false, ConnectionId + 1 - Connections.Num());
+			}
+			Connections[ConnectionId] = true;
+		}
+	}
+
+	TeamRelay->bTeamFilterApplied = ReplicationSystem->SetConnectionFilter(RelayHandle, Connections, UE::Net::ENetFilterStatus::Allow);
+	return TeamRelay->bTeamFilterApplied;
+#else
+	return false;
+#endif
+}
+
+void UChatSubsystem::SendToTeam(const FChatMessage& Message)
+{
+	if (!Message.Sender)
+	{
+		return;
+	}
+
+	const int32* TeamId = TeamByPlayerKey.Find(GetPlayerKey(Message.Sender));
+	if (!TeamId)
+	{
+		return;
+	}
+
+	if (SendThroughTeamRelay(Message, *TeamId))
+	{
+		return;
+	}
+
+	// Only the team's members are visited
+	if (const TArray<int32>* Members = TeamMemberKeys.Find(*TeamId))
+	{
+		for (const int32 MemberKey : *Members)
+		{
+			if (const int32* Index = ComponentIndexByPlayerKey.Find(MemberKey))
+			{
+				DeliverMessage(RegisteredComponents[*Index], Message);
+			}
+		}
+	}
+}
+
+void UChatSubsystem::SendToPlayer(const FChatMessage& Message)
+{
+	if (!Message.WhisperTarget)
+	{
+		return;
+	}
+
+	// Send to the target player
+	UChatComponent* TargetComponent = GetChatComponentForPlayer(Message.WhisperTarget);
+	if (TargetComponent)
+	{
+		DeliverMessage(TargetComponent, Message);
+	}
+
+	// Also send to the sender so they see their own whisper
+	if (Message.Sender)
+	{
+		UChatComponent* SenderComponent = GetChatComponentForPlayer(Message.Sender);
+		if (SenderComponent)
+		{
+			DeliverMessage(SenderComponent, Message);
+		}
+	}
+}
+
+void UChatSubsystem::SendToProximity(const FChatMessage& Message)
+{
+	if (!Message.Sender)
+	{
+		return;
+	}
+
+	// Get sender's pawn location
+	APawn* SenderPawn = Message.Sender->GetPawn();
+	if (!SenderPawn)
+	{
+		return;
+	}
+
+	const FVector SenderLocation = SenderPawn->GetActorLocation();
+
+	if (ChatSettings.bUseProximityGrid)
+	{
+		// Only the cells around the sender are examined
+		RefreshProximityGrid();
+		ProximityGrid.ForEachInRadius(SenderLocation, ChatSettings.ProximityChatRadius, [this, &Message](UChatComponent* Component)
+		{
+			DeliverMessage(Component, Message);
+		});
+		return;
+	}
+
+	const float RadiusSquared = ChatSettings.ProximityChatRadius * ChatSettings.ProximityChatRadius;
+
+	for (UChatComponent* Component : RegisteredComponents)
+	{
+		if (!Component)
+		{
+			continue;
+		}
+
+		APlayerState* PS = Cast<APlayerState>(Component->GetOwner());
+		if (!PS)
+		{
+			continue;
+		}
+
+		APawn* Pawn = PS->GetPawn();
+		if (!Pawn)
+		{
+			continue;
+		}
+
+		// Check if within proximity range
+		const float DistanceSquared = FVector::DistSquared(SenderLocation, Pawn->GetActorLocation());
+		if (DistanceSquared <= RadiusSquared)
+		{
+			DeliverMessage(Component, Message);
+		}
+	}
+}
+
+void UChatSubsystem::SendToChannel(const FChatMessage& Message)
+{
+	const FChatChannelSlot* ChannelSlot = FindChannelSlot(Message.CustomChannelId);
+	if (!ChannelSlot)
+	{
+		return;
+	}
+
+	// Only the channel's subscribers are visited
+	for (const int32 SubscriberKey : ChannelSlot->SubscriberKeys)
+	{
+		if (const int32* Index = ComponentIndexByPlayerKey.Find(SubscriberKey))
+		{
+			DeliverMessage(RegisteredComponents[*Index], Message);
+		}
+	}
+}
+
+void UChatSubsystem::RefreshProximityGrid()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	const double CurrentTime = World->GetTimeSeconds();
+	if (LastProximityGridBuildTime >= 0.0)
+	{
+		const bool bFresh = ChatSettings.ProximityGridRefreshInterval > 0.0f
+			? CurrentTime - LastProximityGridBuildTime < ChatSettings.ProximityGridRefreshInterval
+			: LastProximityGridBuildFrame == GFrameCounter;
+
+		if (bFresh)
+		{
+			return;
+		}
+	}
+
+	ProximityGrid.Reset(ChatSettings.ProximityChatRadius);
+
+	for (UChatComponent* Component : RegisteredComponents)
+	{
+		if (!Component)
+		{
+			continue;
+		}
+
+		const APlayerState* PS = Cast<APlayerState>(Component->GetOwner());
+		const APawn* Pawn = PS ? PS->GetPawn() : nullptr;
+		if (Pawn)
+		{
+			ProximityGrid.Add(Component, Pawn->GetActorLocation());
+		}
+	}
+
+	LastProximityGridBuildTime = CurrentTime;
+	LastProximityGridBuildFrame = GFrameCounter;
+}
+
+UChatComponent* UChatSubsystem::GetChatComponentForPlayer(APlayerState* PlayerState) const
+{
+	if (!PlayerState)
+	{
+		return nullptr;
+	}
+
+	if (const int32* Index = ComponentIndexByPlayerKey.Find(GetPlayerKey(PlayerState)))
+	{
+		UChatComponent* Component = RegisteredComponents[*Index];
+		if (Component && Component->GetOwner() == PlayerState)
+		{
+			return Component;
+		}
+	}
+
+	return nullptr;
+}
+
+void UChatSubsystem::DeliverMessage(UChatComponent* Recipient, const FChatMessage& Message)
+{
+	if (!Recipient)
+	{
+		return;
+	}
+
+	// Skip recipients that muted the sender; no point sending what the client would discard
+	if (IsMutedOnServer(Recipient, Message.Sender))
+	{
+		return;
+	}
+
+	++NumDeliveries;
+
+	// Sent from Tick, highest priority first, as the recipient's budget allows
+	if (ChatSettings.bEnableOutboundBudget)
+	{
+		OutboundQueues.FindOrAdd(Recipient).Enqueue(Message, FPlatformTime::Seconds());
+		++NumOutboundQueued;
+		return;
+	}
+
+	SendToRecipient(Recipient, Message);
+}
+
+void UChatSubsystem::SendToRecipient(UChatComponent* Recipient, const FChatMessage& Message)
+{
+	const EChatDeliveryPolicy Policy = ChatSettings.GetDeliveryPolicy(Message.Channel);
+	const int32 EstimatedBytes = FChatOutboundQueue::EstimateWireSize(Message);
+
+	if (!ChatSettings.bEnableMessageBatching)
+	{
+		if (Policy == EChatDeliveryPolicy::Reliable)
+		{
+			// Held back behind anything already waiting, so messages stay in order
+			FChatPendingBatch* Backlog = PendingBatches.Find(Recipient);
+			if ((Backlog && Backlog->Messages.Num() > 0) || IsReliableBufferSaturated(Recipient))
+			{
+				FChatPendingBatch& Batch = Backlog ? *Backlog : PendingBatches.Add(Recipient);
+				Batch.Messages.Add(Message);
+				Batch.EstimatedBytes += EstimatedBytes;
+				++BatchingStats.ReliableMessagesDeferred;
+				return;
+			}
+
+			Recipient->ClientReceiveMessage(Message);
+		}
+		else
+		{
+			Recipient->ClientReceiveMessageUnreliable(Message);
+			++BatchingStats.UnreliableRPCsSent;
+
+			// The second copy goes out with the next flush
+			if (Policy == EChatDeliveryPolicy::UnreliableRedundant)
+			{
+				PendingBatches.FindOrAdd(Recipient).RedundantCopies.Add(Message);
+			}
+		}
+		ChatStats::RecordRpc(1, EstimatedBytes);
+		return;
+	}
+
+	FChatPendingBatch& Batch = PendingBatches.FindOrAdd(Recipient);
+	switch (Policy)
+	{
+	case EChatDeliveryPolicy::Unreliable:
+		Batch.UnreliableMessages.Add(Message);
+		break;
+
+	case EChatDeliveryPolicy::UnreliableRedundant:
+		Batch.RedundantMessages.Add(Message);
+		break;
+
+	default:
+		Batch.Messages.Add(Message);
+		break;
+	}
+	Batch.EstimatedBytes += EstimatedBytes;
+	++BatchingStats.MessagesBatched;
+
+	// Flush early if the batch hits either threshold
+	if (Batch.NumQueued() >= ChatSettings.MaxBatchSize || Batch.EstimatedBytes >= ChatSettings.MaxBatchBytes)
+	{
+		FlushBatch(Recipient, Batch);
+	}
+}
+
+void UChatSubsystem::FlushBatch(UChatComponent* Recipient, FChatPendingBatch& Batch)
+{
+	if (Recipient && Recipient->GetOwner())
+	{
+		SendReliable(Recipient, Batch);
+
+		// Last flush's redundant messages go out again, ahead of the new ones
+		if (Batch.RedundantCopies.Num() > 0 || Batch.UnreliableMessages.Num() > 0 || Batch.RedundantMessages.Num() > 0)
+		{
+			BatchingStats.RedundantCopiesSent += Batch.RedundantCopies.Num();
+
+			TArray<FChatMessage> Unreliable = MoveTemp(Batch.RedundantCopies);
+			Unreliable.Append(Batch.UnreliableMessages);
+			Unreliable.Append(Batch.RedundantMessages);
+			SendUnreliable(Recipient, Unreliable);
+		}
+
+		Batch.RedundantCopies = MoveTemp(Batch.RedundantMessages);
+	}
+	else
+	{
+		// Nobody left to hold messages back for
+		Batch.Messages.Reset();
+		Batch.NumSkipped = 0;
+		Batch.RedundantCopies.Reset();
+	}
+
+	Batch.UnreliableMessages.Reset();
+	Batch.RedundantMessages.Reset();
+
+	// Held back messages are the only ones left
+	Batch.EstimatedBytes = 0;
+	for (const FChatMessage& Message : Batch.Messages)
+	{
+		Batch.EstimatedBytes += FChatOutboundQueue::EstimateWireSize(Message);
+	}
+}
+
+void UChatSubsystem::SendReliable(UChatComponent* Recipient, FChatPendingBatch& Batch)
+{
+	if (Batch.Messages.Num() == 0 || IsReliableBufferSaturated(Recipient))
+	{
+		// Keep the newest messages, the oldest are the least interesting by the time the client catches up
+		const int32 NumToSkip = Batch.Messages.Num() - FMath::Max(1, ChatSettings.MaxReliableBacklog);
+		if (NumToSkip > 0)
+		{
+			Batch.Messages.RemoveAt(0, NumToSkip, EAllowShrinking::No);
+			Batch.NumSkipped += NumToSkip;
+			BatchingStats.ReliableMessagesSkipped += NumToSkip;
+		}
+		return;
+	}
+
+	// Stands in for the dropped messages, ahead of the ones that were kept
+	if (Batch.NumSkipped > 0)
+	{
+		FChatMessage Summary;
+		Summary.SenderName = FChatMessage::SystemSenderName;
+		Summary.Content = FString::Printf(TEXT("%d messages skipped"), Batch.NumSkipped);
+		Summary.Channel = EChatChannel::System;
+		Summary.Timestamp = FDateTime::Now();
+		Batch.Messages.Insert(MoveTemp(Summary), 0);
+		Batch.NumSkipped = 0;
+	}
+
+	// Chunked so a long backlog doesn't go out as one RPC spanning many reliable bunches
+	const int32 ChunkSize = FMath::Max(1, ChatSettings.MaxBatchSize);
+	int32 NumSent = 0;
+	while (NumSent < Batch.Messages.Num() && !IsReliableBufferSaturated(Recipient))
+	{
+		const int32 Count = FMath::Min(ChunkSize, Batch.Messages.Num() - NumSent);
+
+		// A single message gains nothing from the array wrapper
+		if (Count == 1)
+		{
+			Recipient->ClientReceiveMessage(Batch.Messages[NumSent]);
+		}
+		else if (NumSent == 0 && Count == Batch.Messages.Num())
+		{
+			Recipient->ClientReceiveMessageBatch(Batch.Messages);
+		}
+		else
+		{
+			Recipient->ClientReceiveMessageBatch(TArray<FChatMessage>(Batch.Messages.GetData() + NumSent, Count));
+		}
+
+		int32 EstimatedBytes = 0;
+		for (int32 i = NumSent; i < NumSent + Count; ++i)
+		{
+			EstimatedBytes += FChatOutboundQueue::EstimateWireSize(Batch.Messages[i]);
+		}
+
+		++BatchingStats.RPCsSent;
+		BatchingStats.RPCsSaved += Count - 1;
+		ChatStats::RecordRpc(Count, EstimatedBytes);
+		NumSent += Count;
+	}
+
+	if (NumSent == Batch.Messages.Num())
+	{
+		Batch.Messages.Reset();
+	}
+	else
+	{
+		Batch.Messages.RemoveAt(0, NumSent, EAllowShrinking::No);
+		const int32 NumToSkip = Batch.Messages.Num() - FMath::Max(1, ChatSettings.MaxReliableBacklog);
+		if (NumToSkip > 0)
+		{
+			Batch.Messages.RemoveAt(0, NumToSkip, EAllowShrinking::No);
+			Batch.NumSkipped += NumToSkip;
+			BatchingStats.ReliableMessagesSkipped += NumToSkip;
+		}
+	}
+}
+
+bool UChatSubsystem::IsReliableBufferSaturated(const UChatComponent* Recipient) const
+{
+	if (ReliableBufferSaturatedOverride)
+	{
+		return ReliableBufferSaturatedOverride(Recipient);
+	}
+
+	if (ChatSettings.ReliableBufferThreshold <= 0)
+	{
+		return false;
+	}
+
+	// Client RPCs on the component go out on its PlayerState's actor channel
+	AActor* Owner = Recipient->GetOwner();
+	UNetConnection* Connection = Owner ? Owner->GetNetConnection() : nullptr;
+	if (!Connection)
+	{
+		return false;
+	}
+
+#if UE_WITH_IRIS
+	// Iris doesn't send through actor channels, so NumOutRec says nothing about its reliable queue
+	if (Connection->Driver && Connection->Driver->IsUsingIrisReplication())
+	{
+		return false;
+	}
+#endif
+
+	const UActorChannel* Channel = Connection->FindActorChannelRef(Owner);
+	return Channel && Channel->NumOutRec >= ChatSettings.ReliableBufferThreshold;
+}
+
+void UChatSubsystem::SendUnreliable(UChatComponent* Recipient, const TArray<FChatMessage>& Messages)
+{
+	int32 First = 0;
+	while (First < Messages.Num())
+	{
+		// Always take at least one message, even if it alone is over the limit
+		int32 End = First + 1;
+		int32 EstimatedBytes = FChatOutboundQueue::EstimateWireSize(Messages[First]);
+		while (End < Messages.Num() && EstimatedBytes + FChatOutboundQueue::EstimateWireSize(Messages[End]) <= ChatSettings.MaxBatchBytes)
+		{
+			EstimatedBytes += FChatOutboundQueue::EstimateWireSize(Messages[End]);
+			++End;
+		}
+
+		if (End - First == 1)
+		{
+			Recipient->ClientReceiveMessageUnreliable(Messages[First]);
+		}
+		else
+		{
+			Recipient->ClientReceiveMessageBatchUnreliable(TArray<FChatMessage>(Messages.GetData() + First, End - First));
+		}
+
+		++BatchingStats.UnreliableRPCsSent;
+		ChatStats::RecordRpc(End - First, EstimatedBytes);
+		First = End;
+	}
+}
+
+void UChatSubsystem::DrainOutboundQueues(bool bIgnoreBudget)
+{
+	const double Now = FPlatformTime::Seconds();
+	for (TPair<TObjectPtr<UChatComponent>, FChatOutboundQueue>& Pair : OutboundQueues)
+	{
+		if (Pair.Value.Num() == 0)
+		{
+			continue;
+		}
+
+		UChatComponent* Recipient = Pair.Key;
+		NumOutboundQueued -= Pair.Value.Drain(Now, ChatSettings, bIgnoreBudget, [this, Recipient](const FChatMessage& Message)
+		{
+			SendToRecipient(Recipient, Message);
+		});
+	}
+}
+
+FChatOutboundStats UChatSubsystem::GetOutboundStats(APlayerState* PlayerState) const
+{
+	const FChatOutboundQueue* Queue = OutboundQueues.Find(GetChatComponentForPlayer(PlayerState));
+	return Queue ? Queue->GetStats() : FChatOutboundStats();
+}
+
+void UChatSubsystem::FlushPendingBatches()
+{
+	if (bRelayCopiesPending)
+	{
+		auto FlushRelayCopies = [this](AChatReplicationInfo* Relay)
+		{
+			if (IsValid(Relay) && Relay->RedundantCopies.Num() > 0)
+			{
+				Relay->MulticastReceiveMessageBatchUnreliable(Relay->RedundantCopies);
+				++BatchingStats.RelayMulticastsSent;
+				BatchingStats.RedundantCopiesSent += Relay->RedundantCopies.Num();
+				Relay->RedundantCopies.Reset();
+			}
+		};
+
+		FlushRelayCopies(BroadcastRelay);
+		for (const TPair<int32, TObjectPtr<AChatReplicationInfo>>& Pair : TeamRelays)
+		{
+			FlushRelayCopies(Pair.Value);
+		}
+		bRelayCopiesPending = false;
+	}
+
+	for (auto It = PendingBatches.CreateIterator(); It; ++It)
+	{
+		FlushBatch(It.Key(), It.Value());
+
+		// Recipients stay queued only while they have redundant copies or held back messages left to send
+		if (It.Value().RedundantCopies.Num() == 0 && It.Value().Messages.Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	TimeSinceLastFlush = 0.0f;
+}
+
+void UChatSubsystem::AddToHistory(FChatMessage& Message)
+{
+	InitializeJournal();
+
+	// Ids follow routing order, which asynchronous moderation may make differ from submission order
+	Message.SequenceId = NextSequenceId++;
+
+	// Overwrites the oldest entry in place once MaxHistorySize is reached, so it leaves the index first
+	const bool bRetained = MessageHistory.GetCapacity() > 0;
+	if (bRetained && MessageHistory.Num() == MessageHistory.GetCapacity())
+	{
+		SearchIndex.Remove(MessageHistory[0]);
+	}
+
+	MessageHistory.Add(Message);
+	if (bRetained)
+	{
+		SearchIndex.Add(Message);
+	}
+	ChatStats::SetHistorySize(MessageHistory.Num());
+
+	if (Journal)
+	{
+		Journal->Append(Message);
+	}
+}
+
+void UChatSubsystem::InitializeJournal()
+{
+	if (bJournalInitialized)
+	{
+		return;
+	}
+	if (!ChatSettings.bEnableJournal)
+	{
+		return;
+	}
+
+	// A journal that failed to open is not retried for every message, only when its settings change
+	bJournalInitialized = true;
+
+	// Always read back at least one record, so sequence ids continue from the previous run
+	TArray<FChatMessage> RestoredMessages;
+	const FString Path = GetJournalPath();
+	const int32 MaxRestored = FMath::Max(1, ChatSettings.MaxHistorySize);
+	const int64 MaxSegmentSize = static_cast<int64>(FMath::Max(0, ChatSettings.JournalSegmentSizeMB)) * 1024 * 1024;
+	Journal = FChatJournal::Open(Path, MaxRestored, ChatSettings.JournalFlushInterval, MaxSegmentSize, RestoredMessages);
+
+	// Right after a rotation the live segment holds few messages; fill up from the newest archive
+	TArray<FString> ArchivePaths;
+	if (Journal && RestoredMessages.Num() < MaxRestored)
+	{
+		FChatArchive::FindArchives(Path, ArchivePaths);
+	}
+	if (ArchivePaths.Num() > 0)
+	{
+		if (TUniquePtr<FChatArchive> Archive = FChatArchive::Open(ArchivePaths.Last()))
+		{
+			const int32 NumMissing = MaxRestored - RestoredMessages.Num();
+			const int64 LastArchived = RestoredMessages.Num() > 0 ? RestoredMessages[0].SequenceId - 1 : Archive->GetLastSequenceId();
+			TArray<FChatMessage> ArchivedMessages;
+			Archive->QueryBySequence(LastArchived - NumMissing + 1, LastArchived, NumMissing, ArchivedMessages);
+			RestoredMessages.Insert(MoveTemp(ArchivedMessages), 0);
+		}
+	}
+
+	for (FChatMessage& Restored : RestoredMessages)
+	{
+		if (Restored.SequenceId >= NextSequenceId)
+		{
+			NextSequenceId = Restored.SequenceId + 1;
+			MessageHistory.Add(MoveTemp(Restored));
+		}
+	}
+	RebuildSearchIndex();
+}
+
+FString UChatSubsystem::GetJournalPath() const
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), ChatSettings.JournalPath);
+}
+
+namespace ChatSubsystemConsole
+{
+	bool ParseDateTime(const FString& Text, FDateTime& OutDateTime)
+	{
+		return FDateTime::Parse(Text, OutDateTime) || FDateTime::ParseIso8601(*Text, OutDateTime);
+	}
+
+	void QueryArchive(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		FDateTime From;
+		FDateTime To;
+		if (Args.Num() < 2 || !ParseDateTime(Args[0], From) || !ParseDateTime(Args[1], To))
+		{
+			Ar.Log(TEXT("Usage: Chat.QueryArchive <From> <To> [MaxResults], times as YYYY.MM.DD-HH.MM.SS or ISO 8601"));
+			return;
+		}
+
+		UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		UChatSubsystem* ChatSubsystem = GameInstance ? GameInstance->GetSubsystem<UChatSubsystem>() : nullptr;
+		if (!ChatSubsystem)
+		{
+			Ar.Log(TEXT("No chat subsystem in this world"));
+			return;
+		}
+
+		const int32 MaxResults = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 100;
+		const TArray<FChatMessage> Messages = ChatSubsystem->QueryArchivedMessages(From, To, MaxResults);
+		for (const FChatMessage& Message : Messages)
+		{
+			Ar.Logf(TEXT("[%s] #%lld %s: %s"), *Message.Timestamp.ToString(), Message.SequenceId, *Message.SenderName, *Message.Content);
+		}
+		Ar.Logf(TEXT("%d archived messages"), Messages.Num());
+	}
+
+	FAutoConsoleCommandWithWorldArgsAndOutputDevice QueryArchiveCommand(
+		TEXT("Chat.QueryArchive"),
+		TEXT("Print archived chat messages in a time range: Chat.QueryArchive <From> <To> [MaxResults]"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&QueryArchive));
+}
+
+namespace ChatSubsystemRateLimit
+{
+	/** Seconds between sweeps of UnindexedRateLimitSlots */
+	constexpr double UnindexedPruneInterval = 10.0;
+}
+
+bool UChatSubsystem::ConsumeRateLimitToken(const APlayerState* PlayerState, EChatChannel Channel)
+{
+	// Fail closed: a sender we can't account for doesn't get to bypass the limit
+	UWorld* World = GetWorld();
+	if (!World || !PlayerState)
+	{
+		return false;
+	}
+
+	const double Now = World->GetTimeSeconds();
+	if (const int32* Index = ComponentIndexByPlayerKey.Find(GetPlayerKey(PlayerState)))
+	{
+		return RateLimitSlots[*Index].TryConsume(Now, Channel, ChatSettings);
+	}
+
+	// World time restarts with each map, so a jump backwards also counts as due
+	if (UnindexedRateLimitSlots.Num() > 0 && FMath::Abs(Now - LastUnindexedRateLimitPruneTime) >= ChatSubsystemRateLimit::UnindexedPruneInterval)
+	{
+		PruneUnindexedRateLimitSlots(Now);
+	}
+	return UnindexedRateLimitSlots.FindOrAdd(PlayerState).TryConsume(Now, Channel, ChatSettings);
+}
+
+void UChatSubsystem::PruneUnindexedRateLimitSlots(double Now)
+{
+	LastUnindexedRateLimitPruneTime = Now;
+
+	// A full bucket is what a new slot starts with, so dropping it changes nothing for the sender
+	for (auto It = UnindexedRateLimitSlots.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr() || It.Value().IsFull(Now, ChatSettings))
+		{
+			It.RemoveCurrent();
+		}
+	}
 }
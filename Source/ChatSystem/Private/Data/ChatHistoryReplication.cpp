@@ -0,0 +1,19 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Data/ChatHistoryReplication.h"
+#include "ChatComponent.h"
+
+void FChatHistoryItem::PostReplicatedAdd(const FChatHistoryArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleHistoryMessage(Message);
+	}
+}
+
+void FChatHistoryArray::AddEntry(const FChatMessage& Message)
+{
+	FChatHistoryItem& Item = Items.AddDefaulted_GetRef();
+	Item.Message = Message;
+	MarkItemDirty(Item);
+}
@@ -0,0 +1,190 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Data/ChatMessage.h"
+#include "Engine/PackageMapClient.h"
+
+namespace ChatMessageNetSerialization
+{
+	/** Bits used for EChatChannel on the wire */
+	constexpr uint32 ChannelBits = 3;
+
+	/** How MessageColor is encoded */
+	enum class EColorMode : uint8
+	{
+		White,			// Constructor default
+		ChannelDefault,	// Matches GetDefaultChannelColor
+		Quantized,		// Explicit RGBA8 color follows
+	};
+	constexpr uint32 ColorModeBits = 2;
+
+	/** Presence flags */
+	enum EFlags : uint8
+	{
+		HasSender			= 1 << 0,
+		HasSenderName		= 1 << 1,
+		HasWhisperTarget	= 1 << 2,
+		HasCustomChannel	= 1 << 3,
+	};
+	constexpr uint32 FlagBits = 4;
+
+	/** True if the remote end of this package map has acknowledged the object, so it can resolve it on receipt */
+	bool IsObjectKnownToRemote(UPackageMap* Map, const UObject* Object)
+	{
+		UPackageMapClient* PackageMapClient = Cast<UPackageMapClient>(Map);
+		if (!PackageMapClient || !Object)
+		{
+			return false;
+		}
+
+		const FNetworkGUID NetGUID = PackageMapClient->GetNetGUIDFromObject(Object);
+		return NetGUID.IsValid() && PackageMapClient->NetGUIDHasBeenAckd(NetGUID);
+	}
+}
+
+bool FChatMessage::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	using namespace ChatMessageNetSerialization;
+
+	// Channel
+	uint8 ChannelValue = static_cast<uint8>(Channel);
+	checkSlow(ChannelValue < (1 << ChannelBits));
+	Ar.SerializeBits(&ChannelValue, ChannelBits);
+
+	// Presence flags and color mode
+	uint8 Flags = 0;
+	uint8 ColorMode = static_cast<uint8>(EColorMode::Quantized);
+	if (Ar.IsSaving())
+	{
+		if (Sender)
+		{
+			Flags |= HasSender;
+		}
+
+		// The name only needs to travel if the receiver can't look it up from the Sender itself
+		if (Sender)
+		{
+			if (bForceSenderName || !Sender->GetPlayerName().Equals(SenderName, ESearchCase::CaseSensitive) || !IsObjectKnownToRemote(Map, Sender))
+			{
+				Flags |= HasSenderName;
+			}
+		}
+		else if (!SenderName.Equals(SystemSenderName, ESearchCase::CaseSensitive))
+		{
+			Flags |= HasSenderName;
+		}
+
+		if (WhisperTarget)
+		{
+			Flags |= HasWhisperTarget;
+		}
+
+		if (Channel == EChatChannel::Custom && CustomChannelId != INDEX_NONE)
+		{
+			Flags |= HasCustomChannel;
+		}
+
+		if (MessageColor == FLinearColor::White)
+		{
+			ColorMode = static_cast<uint8>(EColorMode::White);
+		}
+		else if (MessageColor == GetDefaultChannelColor(static_cast<EChatChannel>(ChannelValue)))
+		{
+			ColorMode = static_cast<uint8>(EColorMode::ChannelDefault);
+		}
+	}
+	Ar.SerializeBits(&Flags, FlagBits);
+	Ar.SerializeBits(&ColorMode, ColorModeBits);
+
+	if (Ar.IsLoading())
+	{
+		// The fields are wider than the values they carry; anything out of range is a corrupt or hostile packet
+		if (ChannelValue >= NumChatChannels || ColorMode > static_cast<uint8>(EColorMode::Quantized))
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return true;
+		}
+		Channel = static_cast<EChatChannel>(ChannelValue);
+	}
+
+	// Sequence id, packed since it only grows by one per routed message
+	uint64 Sequence = static_cast<uint64>(SequenceId);
+	Ar.SerializeIntPacked64(Sequence);
+	if (Ar.IsLoading())
+	{
+		SequenceId = static_cast<int64>(Sequence);
+	}
+
+	// Object references
+	UObject* SenderObject = Sender;
+	if (Flags & HasSender)
+	{
+		Map->SerializeObject(Ar, APlayerState::StaticClass(), SenderObject);
+	}
+
+	UObject* WhisperTargetObject = WhisperTarget;
+	if (Flags & HasWhisperTarget)
+	{
+		Map->SerializeObject(Ar, APlayerState::StaticClass(), WhisperTargetObject);
+	}
+
+	if (Ar.IsLoading())
+	{
+		Sender = (Flags & HasSender) ? Cast<APlayerState>(SenderObject) : nullptr;
+		WhisperTarget = (Flags & HasWhisperTarget) ? Cast<APlayerState>(WhisperTargetObject) : nullptr;
+	}
+
+	// Custom channel id
+	if (Flags & HasCustomChannel)
+	{
+		uint32 ChannelId = static_cast<uint32>(CustomChannelId);
+		Ar.SerializeIntPacked(ChannelId);
+		CustomChannelId = static_cast<int32>(ChannelId);
+	}
+	else if (Ar.IsLoading())
+	{
+		CustomChannelId = INDEX_NONE;
+	}
+
+	// Strings
+	if (Flags & HasSenderName)
+	{
+		Ar << SenderName;
+	}
+	else if (Ar.IsLoading())
+	{
+		SenderName = Sender ? Sender->GetPlayerName() : FString(SystemSenderName);
+	}
+
+	Ar << Content;
+
+	// Timestamp, sent as the message age so it is rebased onto the receiver's clock
+	uint64 AgeMs = 0;
+	if (Ar.IsSaving())
+	{
+		AgeMs = static_cast<uint64>(FMath::Max<int64>(0, (FDateTime::Now() - Timestamp).GetTicks() / ETimespan::TicksPerMillisecond));
+	}
+	Ar.SerializeIntPacked64(AgeMs);
+	if (Ar.IsLoading())
+	{
+		Timestamp = FDateTime::Now() - FTimespan::FromMilliseconds(static_cast<double>(AgeMs));
+	}
+
+	// Color
+	if (ColorMode == static_cast<uint8>(EColorMode::Quantized))
+	{
+		FColor QuantizedColor = MessageColor.QuantizeRound();
+		Ar << QuantizedColor;
+		if (Ar.IsLoading())
+		{
+			MessageColor = QuantizedColor.ReinterpretAsLinear();
+		}
+	}
+	else if (Ar.IsLoading())
+	{
+		MessageColor = ColorMode == static_cast<uint8>(EColorMode::White) ? FLinearColor::White : GetDefaultChannelColor(Channel);
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
@@ -12,3 +12,9 @@ void UChatMessageDataObject::SetChatMessage(const FChatMessage& Message)
 {
 	ChatMessage = Message;
 }
+
+void UChatMessageDataObject::ReleaseChatMessage()
+{
+	ChatMessage.Sender = nullptr;
+	ChatMessage.WhisperTarget = nullptr;
+}
@@ -0,0 +1,70 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Data/ChatMessageHistory.h"
+
+void FChatMessageHistory::SetCapacity(int32 NewCapacity)
+{
+	NewCapacity = FMath::Max(0, NewCapacity);
+	if (NewCapacity == Capacity)
+	{
+		return;
+	}
+
+	// Linearize the newest messages that still fit so the buffer starts unwrapped
+	const int32 NumToKeep = FMath::Min(Storage.Num(), NewCapacity);
+	const int32 FirstToKeep = Storage.Num() - NumToKeep;
+
+	TArray<FChatMessage> NewStorage;
+	NewStorage.Reserve(NewCapacity);
+	for (int32 i = FirstToKeep; i < Storage.Num(); ++i)
+	{
+		NewStorage.Add(MoveTemp(Storage[ToStorageIndex(i)]));
+	}
+
+	Storage = MoveTemp(NewStorage);
+	Head = 0;
+	Capacity = NewCapacity;
+}
+
+void FChatMessageHistory::Add(const FChatMessage& Message)
+{
+	Add(FChatMessage(Message));
+}
+
+void FChatMessageHistory::Add(FChatMessage&& Message)
+{
+	if (Capacity <= 0)
+	{
+		return;
+	}
+
+	if (Storage.Num() < Capacity)
+	{
+		Storage.Add(MoveTemp(Message));
+		return;
+	}
+
+	// Full: overwrite the oldest entry and advance the head
+	Storage[Head] = MoveTemp(Message);
+	Head = (Head + 1 == Capacity) ? 0 : Head + 1;
+}
+
+void FChatMessageHistory::GetLast(int32 Count, TArray<FChatMessage>& OutMessages) const
+{
+	if (Count <= 0 || Count > Storage.Num())
+	{
+		Count = Storage.Num();
+	}
+
+	OutMessages.Reset(Count);
+	for (int32 i = Storage.Num() - Count; i < Storage.Num(); ++i)
+	{
+		OutMessages.Add(Storage[ToStorageIndex(i)]);
+	}
+}
+
+void FChatMessageHistory::Empty()
+{
+	Storage.Reset();
+	Head = 0;
+}
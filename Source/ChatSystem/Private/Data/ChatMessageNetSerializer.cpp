@@ -0,0 +1,462 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Data/ChatMessageNetSerializer.h"
+
+#if UE_WITH_IRIS
+
+#include "Data/ChatMessage.h"
+#include "GameFramework/PlayerState.h"
+#include "Iris/Core/NetObjectReference.h"
+#include "Iris/ReplicationState/PropertyNetSerializerInfoRegistry.h"
+#include "Iris/Serialization/NetBitStreamReader.h"
+#include "Iris/Serialization/NetBitStreamUtil.h"
+#include "Iris/Serialization/NetBitStreamWriter.h"
+#include "Iris/Serialization/NetSerializationContext.h"
+#include "Iris/Serialization/NetSerializerArrayStorage.h"
+#include "Iris/Serialization/NetSerializerDelegates.h"
+#include "Iris/Serialization/ObjectNetSerializer.h"
+
+namespace UE::Net
+{
+	namespace ChatMessageNetSerializer
+	{
+		/** Same layout as ChatMessageNetSerialization in ChatMessage.cpp */
+		constexpr uint32 ChannelBits = 3;
+		constexpr uint32 ColorModeBits = 2;
+		constexpr uint32 FlagBits = 4;
+		static_assert(NumChatChannels <= (1 << ChannelBits), "EChatChannel no longer fits in ChannelBits");
+
+		enum class EColorMode : uint8
+		{
+			White,
+			ChannelDefault,
+			Quantized,
+		};
+
+		enum EFlags : uint8
+		{
+			HasSender			= 1 << 0,
+			HasSenderName		= 1 << 1,
+			HasWhisperTarget	= 1 << 2,
+			HasCustomChannel	= 1 << 3,
+		};
+
+		/** Longest string accepted from the wire, in UTF-8 bytes */
+		constexpr uint32 MaxStringBytes = 4096;
+	}
+
+	struct FChatMessageNetSerializer
+	{
+		static constexpr uint32 Version = 0;
+		static constexpr bool bHasDynamicState = true;
+		static constexpr bool bHasCustomNetReference = true;
+
+		/** Strings are kept as UTF-8 */
+		typedef FNetSerializerArrayStorage<uint8> FStringStorage;
+
+		struct FQuantizedType
+		{
+			FNetObjectReference Sender;
+			FNetObjectReference WhisperTarget;
+			FStringStorage SenderName;
+			FStringStorage Content;
+			uint64 SequenceId;
+			uint64 AgeMs;
+			uint32 Color;
+			uint32 CustomChannelId;
+			uint8 Channel;
+			uint8 Flags;
+			uint8 ColorMode;
+		};
+
+		typedef FChatMessage SourceType;
+		typedef FQuantizedType QuantizedType;
+		typedef FChatMessageNetSerializerConfig ConfigType;
+
+		static const ConfigType DefaultConfig;
+
+		static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args);
+		static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args);
+
+		static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args);
+		static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args);
+
+		static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args);
+		static bool Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args);
+
+		static void CloneDynamicState(FNetSerializationContext& Context, const FNetCloneDynamicStateArgs& Args);
+		static void FreeDynamicState(FNetSerializationContext& Context, const FNetFreeDynamicStateArgs& Args);
+
+		static void CollectNetReferences(FNetSerializationContext& Context, const FNetCollectReferencesArgs& Args);
+
+	private:
+		static void QuantizeString(FNetSerializationContext& Context, const FString& Source, FStringStorage& Target);
+		static FString DequantizeString(const FStringStorage& Source);
+		static void WriteString(FNetBitStreamWriter* Writer, const FStringStorage& Source);
+		static void ReadString(FNetSerializationContext& Context, FStringStorage& Target);
+
+		/** The engine's object reference serializer, used for Sender and WhisperTarget */
+		static const FNetSerializer& GetObjectSerializer() { return UE_NET_GET_SERIALIZER(FObjectNetSerializer); }
+
+		class FNetSerializerRegistryDelegates final : private UE::Net::FNetSerializerRegistryDelegates
+		{
+		public:
+			virtual ~FNetSerializerRegistryDelegates();
+
+		private:
+			virtual void OnPreFreezeNetSerializerRegistry() override;
+		};
+
+		static FChatMessageNetSerializer::FNetSerializerRegistryDelegates NetSerializerRegistryDelegates;
+	};
+
+	UE_NET_IMPLEMENT_SERIALIZER(FChatMessageNetSerializer);
+
+	const FChatMessageNetSerializer::ConfigType FChatMessageNetSerializer::DefaultConfig;
+	FChatMessageNetSerializer::FNetSerializerRegistryDelegates FChatMessageNetSerializer::NetSerializerRegistryDelegates;
+
+	static const FName PropertyNetSerializerRegistry_NAME_ChatMessage("ChatMessage");
+	UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ChatMessage, FChatMessageNetSerializer);
+
+	FChatMessageNetSerializer::FNetSerializerRegistryDelegates::~FNetSerializerRegistryDelegates()
+	{
+		UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ChatMessage);
+	}
+
+	void FChatMessageNetSerializer::FNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry()
+	{
+		UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ChatMessage);
+	}
+
+	void FChatMessageNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+	{
+		using namespace ChatMessageNetSerializer;
+
+		const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		FNetBitStreamWriter* Writer = Context.GetBitStreamWriter();
+
+		Writer->WriteBits(Value.Channel, ChannelBits);
+		Writer->WriteBits(Value.Flags, FlagBits);
+		Writer->WriteBits(Value.ColorMode, ColorModeBits);
+
+		// Sequence id, packed since it only grows by one per routed message
+		WritePackedUint64(Writer, Value.SequenceId);
+
+		const FNetSerializer& ObjectSerializer = GetObjectSerializer();
+		FNetSerializeArgs ObjectArgs = Args;
+		ObjectArgs.NetSerializerConfig = ObjectSerializer.DefaultConfig;
+		if (Value.Flags & HasSender)
+		{
+			ObjectArgs.Source = NetSerializerValuePointer(&Value.Sender);
+			ObjectSerializer.Serialize(Context, ObjectArgs);
+		}
+		if (Value.Flags & HasWhisperTarget)
+		{
+			ObjectArgs.Source = NetSerializerValuePointer(&Value.WhisperTarget);
+			ObjectSerializer.Serialize(Context, ObjectArgs);
+		}
+
+		if (Value.Flags & HasCustomChannel)
+		{
+			WritePackedUint32(Writer, Value.CustomChannelId);
+		}
+
+		if (Value.Flags & HasSenderName)
+		{
+			WriteString(Writer, Value.SenderName);
+		}
+		WriteString(Writer, Value.Content);
+
+		WritePackedUint64(Writer, Value.AgeMs);
+
+		if (Value.ColorMode == static_cast<uint8>(EColorMode::Quantized))
+		{
+			Writer->WriteBits(Value.Color, 32);
+		}
+	}
+
+	void FChatMessageNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+	{
+		using namespace ChatMessageNetSerializer;
+
+		QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+		FNetBitStreamReader* Reader = Context.GetBitStreamReader();
+
+		Target.Channel = static_cast<uint8>(Reader->ReadBits(ChannelBits));
+		Target.Flags = static_cast<uint8>(Reader->ReadBits(FlagBits));
+		Target.ColorMode = static_cast<uint8>(Reader->ReadBits(ColorModeBits));
+		if (Target.Channel >= NumChatChannels || Target.ColorMode > static_cast<uint8>(EColorMode::Quantized))
+		{
+			Context.SetError(GNetError_InvalidValue);
+			return;
+		}
+		Target.SequenceId = ReadPackedUint64(Reader);
+
+		const FNetSerializer& ObjectSerializer = GetObjectSerializer();
+		FNetDeserializeArgs ObjectArgs = Args;
+		ObjectArgs.NetSerializerConfig = ObjectSerializer.DefaultConfig;
+
+		Target.Sender = FNetObjectReference();
+		if (Target.Flags & HasSender)
+		{
+			ObjectArgs.Target = NetSerializerValuePointer(&Target.Sender);
+			ObjectSerializer.Deserialize(Context, ObjectArgs);
+		}
+
+		Target.WhisperTarget = FNetObjectReference();
+		if (Target.Flags & HasWhisperTarget)
+		{
+			ObjectArgs.Target = NetSerializerValuePointer(&Target.WhisperTarget);
+			ObjectSerializer.Deserialize(Context, ObjectArgs);
+		}
+
+		Target.CustomChannelId = (Target.Flags & HasCustomChannel) ? ReadPackedUint32(Reader) : static_cast<uint32>(INDEX_NONE);
+
+		if (Target.Flags & HasSenderName)
+		{
+			ReadString(Context, Target.SenderName);
+		}
+		else
+		{
+			Target.SenderName.AdjustSize(Context, 0);
+		}
+		ReadString(Context, Target.Content);
+
+		Target.AgeMs = ReadPackedUint64(Reader);
+		Target.Color = Target.ColorMode == static_cast<uint8>(EColorMode::Quantized) ? Reader->ReadBits(32) : 0U;
+	}
+
+	void FChatMessageNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+	{
+		using namespace ChatMessageNetSerializer;
+
+		const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+		QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+
+		Target.Channel = static_cast<uint8>(Source.Channel);
+		Target.SequenceId = static_cast<uint64>(Source.SequenceId);
+		Target.CustomChannelId = static_cast<uint32>(Source.CustomChannelId);
+
+		Target.Flags = 0;
+		if (Source.Sender)
+		{
+			Target.Flags |= HasSender;
+		}
+		if (Source.WhisperTarget)
+		{
+			Target.Flags |= HasWhisperTarget;
+		}
+		if (Source.Channel == EChatChannel::Custom && Source.CustomChannelId != INDEX_NONE)
+		{
+			Target.Flags |= HasCustomChannel;
+		}
+		if (Source.Sender || !Source.SenderName.Equals(FChatMessage::SystemSenderName, ESearchCase::CaseSensitive))
+		{
+			Target.Flags |= HasSenderName;
+		}
+
+		const FNetSerializer& ObjectSerializer = GetObjectSerializer();
+		FNetQuantizeArgs ObjectArgs = Args;
+		ObjectArgs.NetSerializerConfig = ObjectSerializer.DefaultConfig;
+		ObjectArgs.Source = NetSerializerValuePointer(&Source.Sender);
+		ObjectArgs.Target = NetSerializerValuePointer(&Target.Sender);
+		ObjectSerializer.Quantize(Context, ObjectArgs);
+		ObjectArgs.Source = NetSerializerValuePointer(&Source.WhisperTarget);
+		ObjectArgs.Target = NetSerializerValuePointer(&Target.WhisperTarget);
+		ObjectSerializer.Quantize(Context, ObjectArgs);
+
+		QuantizeString(Context, (Target.Flags & HasSenderName) ? Source.SenderName : FString(), Target.SenderName);
+		QuantizeString(Context, Source.Content, Target.Content);
+
+		// Sent as the message age so it is rebased onto the receiver's clock
+		Target.AgeMs = static_cast<uint64>(FMath::Max<int64>(0, (FDateTime::Now() - Source.Timestamp).GetTicks() / ETimespan::TicksPerMillisecond));
+
+		Target.Color = 0;
+		if (Source.MessageColor == FLinearColor::White)
+		{
+			Target.ColorMode = static_cast<uint8>(EColorMode::White);
+		}
+		else if (Source.MessageColor == FChatMessage::GetDefaultChannelColor(Source.Channel))
+		{
+			Target.ColorMode = static_cast<uint8>(EColorMode::ChannelDefault);
+		}
+		else
+		{
+			Target.ColorMode = static_cast<uint8>(EColorMode::Quantized);
+			Target.Color = Source.MessageColor.QuantizeRound().DWColor();
+		}
+	}
+
+	void FChatMessageNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+	{
+		using namespace ChatMessageNetSerializer;
+
+		const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		SourceType& Target = *reinterpret_cast<SourceType*>(Args.Target);
+
+		Target.Channel = static_cast<EChatChannel>(Source.Channel);
+		Target.SequenceId = static_cast<int64>(Source.SequenceId);
+		Target.CustomChannelId = (Source.Flags & HasCustomChannel) ? static_cast<int32>(Source.CustomChannelId) : INDEX_NONE;
+
+		const FNetSerializer& ObjectSerializer = GetObjectSerializer();
+		FNetDequantizeArgs ObjectArgs = Args;
+		ObjectArgs.NetSerializerConfig = ObjectSerializer.DefaultConfig;
+
+		TObjectPtr<UObject> Object;
+		ObjectArgs.Source = NetSerializerValuePointer(&Source.Sender);
+		ObjectArgs.Target = NetSerializerValuePointer(&Object);
+		ObjectSerializer.Dequantize(Context, ObjectArgs);
+		Target.Sender = (Source.Flags & HasSender) ? Cast<APlayerState>(Object) : nullptr;
+
+		Object = nullptr;
+		ObjectArgs.Source = NetSerializerValuePointer(&Source.WhisperTarget);
+		ObjectSerializer.Dequantize(Context, ObjectArgs);
+		Target.WhisperTarget = (Source.Flags & HasWhisperTarget) ? Cast<APlayerState>(Object) : nullptr;
+
+		Target.SenderName = (Source.Flags & HasSenderName) ? DequantizeString(Source.SenderName) : FString(FChatMessage::SystemSenderName);
+		Target.Content = DequantizeString(Source.Content);
+
+		Target.Timestamp = FDateTime::Now() - FTimespan::FromMilliseconds(static_cast<double>(Source.AgeMs));
+
+		switch (static_cast<EColorMode>(Source.ColorMode))
+		{
+		case EColorMode::White:
+			Target.MessageColor = FLinearColor::White;
+			break;
+
+		case EColorMode::ChannelDefault:
+			Target.MessageColor = FChatMessage::GetDefaultChannelColor(Target.Channel);
+			break;
+
+		default:
+			Target.MessageColor = FColor(Source.Color).ReinterpretAsLinear();
+			break;
+		}
+	}
+
+	bool FChatMessageNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+	{
+		if (Args.bStateIsQuantized)
+		{
+			const QuantizedType& A = *reinterpret_cast<const QuantizedType*>(Args.Source0);
+			const QuantizedType& B = *reinterpret_cast<const QuantizedType*>(Args.Source1);
+
+			auto StringsEqual = [](const FStringStorage& X, const FStringStorage& Y)
+			{
+				return X.Num() == Y.Num() && (X.Num() == 0 || FMemory::Memcmp(X.GetData(), Y.GetData(), X.Num()) == 0);
+			};
+
+			return A.Channel == B.Channel && A.Flags == B.Flags && A.ColorMode == B.ColorMode && A.Color == B.Color
+				&& A.SequenceId == B.SequenceId && A.CustomChannelId == B.CustomChannelId && A.AgeMs == B.AgeMs
+				&& A.Sender == B.Sender && A.WhisperTarget == B.WhisperTarget
+				&& StringsEqual(A.SenderName, B.SenderName) && StringsEqual(A.Content, B.Content);
+		}
+
+		const SourceType& A = *reinterpret_cast<const SourceType*>(Args.Source0);
+		const SourceType& B = *reinterpret_cast<const SourceType*>(Args.Source1);
+		return A.Channel == B.Channel && A.SequenceId == B.SequenceId && A.CustomChannelId == B.CustomChannelId
+			&& A.Sender == B.Sender && A.WhisperTarget == B.WhisperTarget && A.Timestamp == B.Timestamp
+			&& A.MessageColor == B.MessageColor
+			&& A.SenderName.Equals(B.SenderName, ESearchCase::CaseSensitive) && A.Content.Equals(B.Content, ESearchCase::CaseSensitive);
+	}
+
+	bool FChatMessageNetSerializer::Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args)
+	{
+		using namespace ChatMessageNetSerializer;
+
+		const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+		return static_cast<int32>(Source.Channel) < NumChatChannels
+			&& FTCHARToUTF8(*Source.SenderName).Length() <= static_cast<int32>(MaxStringBytes)
+			&& FTCHARToUTF8(*Source.Content).Length() <= static_cast<int32>(MaxStringBytes);
+	}
+
+	void FChatMessageNetSerializer::CloneDynamicState(FNetSerializationContext& Context, const FNetCloneDynamicStateArgs& Args)
+	{
+		const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+		QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+
+		Target.SenderName.Clone(Context, Source.SenderName);
+		Target.Content.Clone(Context, Source.Content);
+	}
+
+	void FChatMessageNetSerializer::FreeDynamicState(FNetSerializationContext& Context, const FNetFreeDynamicStateArgs& Args)
+	{
+		QuantizedType& Value = *reinterpret_cast<QuantizedType*>(Args.Source);
+
+		Value.SenderName.Free(Context);
+		Value.Content.Free(Context);
+	}
+
+	void FChatMessageNetSerializer::CollectNetReferences(FNetSerializationContext& Context, const FNetCollectReferencesArgs& Args)
+	{
+		using namespace ChatMessageNetSerializer;
+
+		const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+
+		const FNetSerializer& ObjectSerializer = GetObjectSerializer();
+		FNetCollectReferencesArgs ObjectArgs = Args;
+		ObjectArgs.NetSerializerConfig = ObjectSerializer.DefaultConfig;
+		if (Value.Flags & HasSender)
+		{
+			ObjectArgs.Source = NetSerializerValuePointer(&Value.Sender);
+			ObjectSerializer.CollectNetReferences(Context, ObjectArgs);
+		}
+		if (Value.Flags & HasWhisperTarget)
+		{
+			ObjectArgs.Source = NetSerializerValuePointer(&Value.WhisperTarget);
+			ObjectSerializer.CollectNetReferences(Context, ObjectArgs);
+		}
+	}
+
+	void FChatMessageNetSerializer::QuantizeString(FNetSerializationContext& Context, const FString& Source, FStringStorage& Target)
+	{
+		const FTCHARToUTF8 Converter(*Source);
+		Target.AdjustSize(Context, Converter.Length());
+		if (Converter.Length() > 0)
+		{
+			FMemory::Memcpy(Target.GetData(), Converter.Get(), Converter.Length());
+		}
+	}
+
+	FString FChatMessageNetSerializer::DequantizeString(const FStringStorage& Source)
+	{
+		if (Source.Num() == 0)
+		{
+			return FString();
+		}
+
+		const FUTF8ToTCHAR Converter(reinterpret_cast<const UTF8CHAR*>(Source.GetData()), Source.Num());
+		return FString::ConstructFromPtrSize(Converter.Get(), Converter.Length());
+	}
+
+	void FChatMessageNetSerializer::WriteString(FNetBitStreamWriter* Writer, const FStringStorage& Source)
+	{
+		WritePackedUint32(Writer, Source.Num());
+		for (uint32 i = 0; i < Source.Num(); ++i)
+		{
+			Writer->WriteBits(Source.GetData()[i], 8);
+		}
+	}
+
+	void FChatMessageNetSerializer::ReadString(FNetSerializationContext& Context, FStringStorage& Target)
+	{
+		using namespace ChatMessageNetSerializer;
+
+		FNetBitStreamReader* Reader = Context.GetBitStreamReader();
+		const uint32 Length = ReadPackedUint32(Reader);
+		if (Length > MaxStringBytes)
+		{
+			Context.SetError(GNetError_ArraySizeTooLarge);
+			Target.AdjustSize(Context, 0);
+			return;
+		}
+
+		Target.AdjustSize(Context, Length);
+		for (uint32 i = 0; i < Length; ++i)
+		{
+			Target.GetData()[i] = static_cast<uint8>(Reader->ReadBits(8));
+		}
+	}
+}
+
+#endif // UE_WITH_IRIS
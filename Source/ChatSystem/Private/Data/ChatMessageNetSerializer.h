@@ -0,0 +1,26 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Iris/Serialization/NetSerializer.h"
+#include "ChatMessageNetSerializer.generated.h"
+
+/**
+ * Config for the Iris serializer of FChatMessage, which has no options
+ */
+USTRUCT()
+struct FChatMessageNetSerializerConfig : public FNetSerializerConfig
+{
+	GENERATED_BODY()
+};
+
+namespace UE::Net
+{
+	/**
+	 * Iris counterpart of FChatMessage::NetSerialize, registered for FChatMessage when UE_WITH_IRIS is set
+	 * Uses the same encoding except SenderName: Iris quantizes an RPC's parameters once for every connection,
+	 * so the name is always sent rather than dropped for connections that already know the Sender
+	 */
+	UE_NET_DECLARE_SERIALIZER(FChatMessageNetSerializer, CHATSYSTEM_API);
+}
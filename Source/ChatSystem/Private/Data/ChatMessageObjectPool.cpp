@@ -0,0 +1,60 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Data/ChatMessageObjectPool.h"
+#include "Data/ChatMessageDataObject.h"
+
+UChatMessageDataObject* FChatMessageObjectPool::Add(UObject* Outer, const FChatMessage& Message, int32 MaxRetained, TArray<UChatMessageDataObject*>& OutEvicted)
+{
+	// Make room first so the evicted object can be reused right away
+	Trim(FMath::Max(1, MaxRetained) - 1, OutEvicted);
+
+	UChatMessageDataObject* Object = nullptr;
+	if (Free.Num() > 0)
+	{
+		Object = Free.Pop(EAllowShrinking::No);
+		++Hits;
+	}
+	else
+	{
+		Object = NewObject<UChatMessageDataObject>(Outer);
+		++Misses;
+	}
+
+	Object->SetChatMessage(Message);
+	Retained.Add(Object);
+	return Object;
+}
+
+void FChatMessageObjectPool::Trim(int32 MaxRetained, TArray<UChatMessageDataObject*>& OutEvicted)
+{
+	while (Retained.Num() > FMath::Max(0, MaxRetained))
+	{
+		OutEvicted.Add(EvictOldest());
+	}
+}
+
+UChatMessageDataObject* FChatMessageObjectPool::EvictOldest()
+{
+	UChatMessageDataObject* Object = Retained[0];
+	Retained.RemoveAt(0, 1, EAllowShrinking::No);
+
+	Object->ReleaseChatMessage();
+	Free.Add(Object);
+	return Object;
+}
+
+FChatMessagePoolStats FChatMessageObjectPool::GetStats() const
+{
+	FChatMessagePoolStats Stats;
+	Stats.Hits = Hits;
+	Stats.Misses = Misses;
+	Stats.NumRetained = Retained.Num();
+	Stats.NumFree = Free.Num();
+	return Stats;
+}
+
+void FChatMessageObjectPool::Empty()
+{
+	Retained.Empty();
+	Free.Empty();
+}
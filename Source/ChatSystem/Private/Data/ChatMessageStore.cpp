@@ -0,0 +1,100 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Data/ChatMessageStore.h"
+
+FChatMessageStore::FChatMessageStore()
+{
+	Channels.SetNum(NumChatChannels);
+}
+
+void FChatMessageStore::SetCapacity(int32 NewCapacity)
+{
+	Capacity = FMath::Max(0, NewCapacity);
+	for (int32 ChannelIndex = 0; ChannelIndex < NumChatChannels; ++ChannelIndex)
+	{
+		const int32 NumBefore = Channels[ChannelIndex].Num();
+		Channels[ChannelIndex].SetCapacity(Capacity);
+		if (Channels[ChannelIndex].Num() != NumBefore)
+		{
+			DirtyChannels |= 1u << ChannelIndex;
+		}
+	}
+}
+
+void FChatMessageStore::Add(const FChatMessage& Message)
+{
+	if (Capacity <= 0)
+	{
+		return;
+	}
+
+	const int32 ChannelIndex = static_cast<int32>(Message.Channel);
+	Channels[ChannelIndex].Add(Message);
+	++NumAdded[ChannelIndex];
+	DirtyChannels |= 1u << ChannelIndex;
+}
+
+const FChatMessage* FChatMessageStore::Find(EChatChannel Channel, int64 Index) const
+{
+	const FChatMessageHistory& History = Channels[static_cast<int32>(Channel)];
+	const int64 Offset = Index - GetFirstIndex(Channel);
+	return Offset >= 0 && Offset < History.Num() ? &History[static_cast<int32>(Offset)] : nullptr;
+}
+
+void FChatMessageStore::GetRange(EChatChannel Channel, int64 FirstIndex, int32 Count, TArray<FChatMessage>& OutMessages) const
+{
+	const FChatMessageHistory& History = Channels[static_cast<int32>(Channel)];
+	const int64 RetainedFirst = GetFirstIndex(Channel);
+
+	// Clip the requested range to what is retained
+	const int64 First = FMath::Max(FirstIndex, RetainedFirst);
+	const int64 End = FMath::Min(FirstIndex + FMath::Max(0, Count), GetEndIndex(Channel));
+
+	OutMessages.Reset(static_cast<int32>(FMath::Max<int64>(0, End - First)));
+	for (int64 Index = First; Index < End; ++Index)
+	{
+		OutMessages.Add(History[static_cast<int32>(Index - RetainedFirst)]);
+	}
+}
+
+void FChatMessageStore::ConsumeChanges(TArray<FChatStoreChange>& OutChanges)
+{
+	OutChanges.Reset();
+
+	for (int32 ChannelIndex = 0; ChannelIndex < NumChatChannels; ++ChannelIndex)
+	{
+		if (!(DirtyChannels & (1u << ChannelIndex)))
+		{
+			continue;
+		}
+
+		const EChatChannel Channel = static_cast<EChatChannel>(ChannelIndex);
+		const int64 First = GetFirstIndex(Channel);
+		const int64 End = GetEndIndex(Channel);
+
+		// Messages appended and evicted again since the last notification never show up in either range
+		FChatStoreChange& Change = OutChanges.AddDefaulted_GetRef();
+		Change.Channel = Channel;
+		Change.FirstEvicted = NotifiedFirst[ChannelIndex];
+		Change.NumEvicted = static_cast<int32>(FMath::Max<int64>(0, FMath::Min(First, NotifiedEnd[ChannelIndex]) - NotifiedFirst[ChannelIndex]));
+		Change.FirstAppended = FMath::Max(NotifiedEnd[ChannelIndex], First);
+		Change.NumAppended = static_cast<int32>(End - Change.FirstAppended);
+
+		NotifiedFirst[ChannelIndex] = First;
+		NotifiedEnd[ChannelIndex] = End;
+	}
+
+	DirtyChannels = 0;
+}
+
+void FChatMessageStore::Empty()
+{
+	for (int32 ChannelIndex = 0; ChannelIndex < NumChatChannels; ++ChannelIndex)
+	{
+		if (Channels[ChannelIndex].Num() > 0)
+		{
+			Channels[ChannelIndex].Empty();
+			DirtyChannels |= 1u << ChannelIndex;
+		}
+	}
+}
@@ -0,0 +1,164 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Data/ChatSearchIndex.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Reverse.h"
+
+namespace ChatSearchIndex
+{
+	/** Longer words are not indexed, they are almost always spam */
+	constexpr int32 MaxTokenLength = 32;
+
+	/** Compact a posting list once this many evicted entries sit at its front */
+	constexpr int32 MinCompactCount = 32;
+}
+
+bool FChatSearchIndex::Tokenize(const FString& Text, TArray<FString>& OutTokens)
+{
+	const int32 NumBefore = OutTokens.Num();
+	bool bAllIndexable = true;
+	FString Token;
+	for (int32 i = 0; i <= Text.Len(); ++i)
+	{
+		const TCHAR Char = i < Text.Len() ? Text[i] : TEXT('\0');
+		if (FChar::IsAlnum(Char))
+		{
+			Token.AppendChar(FChar::ToLower(Char));
+			continue;
+		}
+
+		if (!Token.IsEmpty())
+		{
+			if (Token.Len() > ChatSearchIndex::MaxTokenLength)
+			{
+				bAllIndexable = false;
+			}
+			else if (!MakeArrayView(OutTokens).RightChop(NumBefore).Contains(Token))
+			{
+				OutTokens.Add(Token);
+			}
+			Token.Reset();
+		}
+	}
+	return bAllIndexable;
+}
+
+FString FChatSearchIndex::MakeSenderKey(const FString& SenderName)
+{
+	// Names can contain spaces, which would split a query term, so they are matched without them
+	return SenderPrefix + SenderName.ToLower().Replace(TEXT(" "), TEXT(""));
+}
+
+void FChatSearchIndex::GetTerms(const FChatMessage& Message, TArray<FString>& OutTerms)
+{
+	OutTerms.Reset();
+	Tokenize(Message.Content, OutTerms);
+	if (!Message.SenderName.IsEmpty())
+	{
+		OutTerms.Add(MakeSenderKey(Message.SenderName));
+	}
+}
+
+void FChatSearchIndex::Add(const FChatMessage& Message)
+{
+	TArray<FString> Terms;
+	GetTerms(Message, Terms);
+	for (FString& Term : Terms)
+	{
+		FPostingList& List = Postings.FindOrAdd(MoveTemp(Term));
+		ensure(List.SequenceIds.Num() == List.First || List.SequenceIds.Last() < Message.SequenceId);
+		List.SequenceIds.Add(Message.SequenceId);
+	}
+}
+
+void FChatSearchIndex::Remove(const FChatMessage& Message)
+{
+	TArray<FString> Terms;
+	GetTerms(Message, Terms);
+	for (const FString& Term : Terms)
+	{
+		FPostingList* List = Postings.Find(Term);
+		if (!List || !ensure(List->SequenceIds[List->First] == Message.SequenceId))
+		{
+			continue;
+		}
+
+		++List->First;
+		if (List->First == List->SequenceIds.Num())
+		{
+			Postings.Remove(Term);
+		}
+		else if (List->First >= ChatSearchIndex::MinCompactCount && List->First * 2 >= List->SequenceIds.Num())
+		{
+			List->SequenceIds.RemoveAt(0, List->First, EAllowShrinking::No);
+			List->First = 0;
+		}
+	}
+}
+
+void FChatSearchIndex::Search(const FString& Query, int32 MaxResults, TFunctionRef<bool(int64)> Filter, TArray<int64>& OutSequenceIds) const
+{
+	OutSequenceIds.Reset();
+	if (MaxResults <= 0)
+	{
+		return;
+	}
+
+	TArray<FString> Terms;
+	TArray<FString> Words;
+	Query.ParseIntoArrayWS(Words);
+	for (const FString& Word : Words)
+	{
+		if (Word.StartsWith(SenderPrefix))
+		{
+			Terms.AddUnique(MakeSenderKey(Word.RightChop(FCString::Strlen(SenderPrefix))));
+		}
+		else if (!Tokenize(Word, Terms))
+		{
+			// Dropping the word would return a superset of what was asked for
+			return;
+		}
+	}
+
+	// Every term has to be indexed for anything to match
+	TArray<TConstArrayView<int64>, TInlineAllocator<8>> Lists;
+	for (const FString& Term : Terms)
+	{
+		const FPostingList* List = Postings.Find(Term);
+		if (!List)
+		{
+			return;
+		}
+		Lists.Add(List->GetLive());
+	}
+
+	if (Lists.Num() == 0)
+	{
+		return;
+	}
+
+	// Walk the shortest list newest first and probe the others
+	Lists.Sort([](const TConstArrayView<int64>& A, const TConstArrayView<int64>& B) { return A.Num() < B.Num(); });
+	for (int32 i = Lists[0].Num() - 1; i >= 0 && OutSequenceIds.Num() < MaxResults; --i)
+	{
+		const int64 SequenceId = Lists[0][i];
+
+		bool bInAll = true;
+		for (int32 ListIndex = 1; ListIndex < Lists.Num() && bInAll; ++ListIndex)
+		{
+			bInAll = Algo::BinarySearch(Lists[ListIndex], SequenceId) != INDEX_NONE;
+		}
+
+		if (bInAll && Filter(SequenceId))
+		{
+			OutSequenceIds.Add(SequenceId);
+		}
+	}
+
+	Algo::Reverse(OutSequenceIds);
+}
+
+void FChatSearchIndex::Empty()
+{
+	Postings.Empty();
+}
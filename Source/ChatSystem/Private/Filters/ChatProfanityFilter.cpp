@@ -0,0 +1,367 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Filters/ChatProfanityFilter.h"
+#include "Misc/FileHelper.h"
+#include "Containers/Queue.h"
+
+namespace ChatProfanityFilter
+{
+	/** Symbols commonly typed in place of letters */
+	bool IsSubstitutionSymbol(TCHAR Char)
+	{
+		return Char == TEXT('!') || Char == TEXT('@') || Char == TEXT('$');
+	}
+
+	bool ContainsLetter(const FString& Text)
+	{
+		for (const TCHAR Char : Text)
+		{
+			if (FChar::IsAlpha(Char))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+bool FChatProfanityFilter::IsWordChar(const FString& Text, int32 Index)
+{
+	const TCHAR Char = Text[Index];
+	if (FChar::IsAlnum(Char))
+	{
+		return true;
+	}
+
+	// "sh!t" and "$hit", but not the "!" ending "hello!"
+	return ChatProfanityFilter::IsSubstitutionSymbol(Char) && Index + 1 < Text.Len() && FChar::IsAlnum(Text[Index + 1]);
+}
+
+TCHAR FChatProfanityFilter::Normalize(TCHAR Char)
+{
+	// Undo the usual character substitutions so "b4d" matches "bad"
+	switch (Char)
+	{
+	case TEXT('0'): return TEXT('o');
+	case TEXT('1'): return TEXT('i');
+	case TEXT('!'): return TEXT('i');
+	case TEXT('3'): return TEXT('e');
+	case TEXT('4'): return TEXT('a');
+	case TEXT('@'): return TEXT('a');
+	case TEXT('5'): return TEXT('s');
+	case TEXT('$'): return TEXT('s');
+	case TEXT('7'): return TEXT('t');
+	default: return FChar::ToLower(Char);
+	}
+}
+
+TSharedRef<const FChatProfanityFilter> FChatProfanityFilter::Build(const TArray<FString>& Words)
+{
+	TSharedRef<FChatProfanityFilter> Filter = MakeShared<FChatProfanityFilter>();
+
+	// Build the trie with per-node child lists, flattened once failure links are known
+	struct FBuildNode
+	{
+		TArray<TPair<TCHAR, int32>, TInlineAllocator<2>> Children;
+		int32 Fail = 0;
+		int32 MatchLength = 0;
+		uint8 MatchFlags = 0;
+	};
+
+	TArray<FBuildNode> BuildNodes;
+	BuildNodes.AddDefaulted();
+
+	for (const FString& Word : Words)
+	{
+		FString Pattern = Word;
+		uint8 Flags = 0;
+		if (Pattern.StartsWith(TEXT("*")))
+		{
+			Flags |= AnyStart;
+			Pattern.RightChopInline(1);
+		}
+		if (Pattern.EndsWith(TEXT("*")))
+		{
+			Flags |= AnyEnd;
+			Pattern.LeftChopInline(1);
+		}
+
+		if (Pattern.IsEmpty())
+		{
+			continue;
+		}
+
+		// Folded the same way the text is, so "a55" in the list still matches "ass" in a message
+		const bool bFold = ChatProfanityFilter::ContainsLetter(Pattern);
+
+		int32 State = 0;
+		for (const TCHAR RawChar : Pattern)
+		{
+			const TCHAR Char = bFold ? Normalize(RawChar) : FChar::ToLower(RawChar);
+			int32 Next = INDEX_NONE;
+			for (const TPair<TCHAR, int32>& Child : BuildNodes[State].Children)
+			{
+				if (Child.Key == Char)
+				{
+					Next = Child.Value;
+					break;
+				}
+			}
+
+			if (Next == INDEX_NONE)
+			{
+				Next = BuildNodes.AddDefaulted();
+				BuildNodes[State].Children.Emplace(Char, Next);
+			}
+			State = Next;
+		}
+
+		if (BuildNodes[State].MatchLength == 0)
+		{
+			++Filter->NumPatterns;
+		}
+
+		// The same word listed twice matches wherever either entry allows
+		BuildNodes[State].MatchLength = Pattern.Len();
+		BuildNodes[State].MatchFlags |= Flags;
+	}
+
+	// Flatten edges, sorted by character so lookups can binary search
+	Filter->Nodes.SetNum(BuildNodes.Num());
+	for (int32 i = 0; i < BuildNodes.Num(); ++i)
+	{
+		BuildNodes[i].Children.Sort([](const TPair<TCHAR, int32>& A, const TPair<TCHAR, int32>& B) { return A.Key < B.Key; });
+
+		FNode& Node = Filter->Nodes[i];
+		Node.FirstEdge = Filter->EdgeChars.Num();
+		Node.NumEdges = BuildNodes[i].Children.Num();
+		Node.MatchLength = BuildNodes[i].MatchLength;
+		Node.MatchFlags = BuildNodes[i].MatchFlags;
+		for (const TPair<TCHAR, int32>& Child : BuildNodes[i].Children)
+		{
+			Filter->EdgeChars.Add(Child.Key);
+			Filter->EdgeTargets.Add(Child.Value);
+		}
+	}
+
+	for (int32& Entry : Filter->RootTable)
+	{
+		Entry = INDEX_NONE;
+	}
+	for (const TPair<TCHAR, int32>& Child : BuildNodes[0].Children)
+	{
+		if (Child.Key < RootTableSize)
+		{
+			Filter->RootTable[Child.Key] = Child.Value;
+		}
+	}
+
+	// Breadth-first pass to compute failure links; each state also links to the nearest suffix
+	// state that ends a word, so a scan can visit every word ending at a position
+	TQueue<int32> Pending;
+	for (const TPair<TCHAR, int32>& Child : BuildNodes[0].Children)
+	{
+		Filter->Nodes[Child.Value].Fail = 0;
+		Pending.Enqueue(Child.Value);
+	}
+
+	int32 State;
+	while (Pending.Dequeue(State))
+	{
+		for (const TPair<TCHAR, int32>& Child : BuildNodes[State].Children)
+		{
+			int32 Fallback = Filter->Nodes[State].Fail;
+			int32 FailTarget = Filter->FindEdge(Fallback, Child.Key);
+			while (FailTarget == INDEX_NONE && Fallback != 0)
+			{
+				Fallback = Filter->Nodes[Fallback].Fail;
+				FailTarget = Filter->FindEdge(Fallback, Child.Key);
+			}
+
+			FNode& ChildNode = Filter->Nodes[Child.Value];
+			ChildNode.Fail = (FailTarget == INDEX_NONE || FailTarget == Child.Value) ? 0 : FailTarget;
+			const FNode& FailNode = Filter->Nodes[ChildNode.Fail];
+			ChildNode.Output = FailNode.MatchLength > 0 ? ChildNode.Fail : FailNode.Output;
+			Pending.Enqueue(Child.Value);
+		}
+	}
+
+	return Filter;
+}
+
+TSharedPtr<const FChatProfanityFilter> FChatProfanityFilter::BuildFromFile(const FString& FilePath)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *FilePath))
+	{
+		return nullptr;
+	}
+
+	TArray<FString> Words;
+	Words.Reserve(Lines.Num());
+	for (FString& Line : Lines)
+	{
+		Line.TrimStartAndEndInline();
+		if (!Line.IsEmpty() && !Line.StartsWith(TEXT("#")))
+		{
+			Words.Add(MoveTemp(Line));
+		}
+	}
+
+	return Build(Words);
+}
+
+int32 FChatProfanityFilter::FindEdge(int32 State, TCHAR Char) const
+{
+	if (State == 0 && Char < RootTableSize)
+	{
+		return RootTable[Char];
+	}
+
+	const FNode& Node = Nodes[State];
+	int32 Low = Node.FirstEdge;
+	int32 High = Node.FirstEdge + Node.NumEdges;
+	while (Low < High)
+	{
+		const int32 Mid = (Low + High) / 2;
+		if (EdgeChars[Mid] < Char)
+		{
+			Low = Mid + 1;
+		}
+		else
+		{
+			High = Mid;
+		}
+	}
+
+	return (Low < Node.FirstEdge + Node.NumEdges && EdgeChars[Low] == Char) ? EdgeTargets[Low] : INDEX_NONE;
+}
+
+int32 FChatProfanityFilter::Step(int32 State, TCHAR Char) const
+{
+	for (;;)
+	{
+		const int32 Next = FindEdge(State, Char);
+		if (Next != INDEX_NONE)
+		{
+			return Next;
+		}
+
+		if (State == 0)
+		{
+			return 0;
+		}
+		State = Nodes[State].Fail;
+	}
+}
+
+void FChatProfanityFilter::ForEachMatch(const FString& Text, TFunctionRef<bool(int32 Start, int32 End)> Visitor) const
+{
+	const int32 Len = Text.Len();
+	int32 WordStart = 0;
+	while (WordStart < Len)
+	{
+		if (!IsWordChar(Text, WordStart))
+		{
+			++WordStart;
+			continue;
+		}
+
+		int32 WordEnd = WordStart;
+		bool bHasLetter = false;
+		while (WordEnd < Len && IsWordChar(Text, WordEnd))
+		{
+			bHasLetter |= FChar::IsAlpha(Text[WordEnd]);
+			++WordEnd;
+		}
+
+		// Each word is scanned on its own, so a match can never span two of them
+		int32 State = 0;
+		for (int32 i = WordStart; i < WordEnd; ++i)
+		{
+			State = Step(State, bHasLetter ? Normalize(Text[i]) : FChar::ToLower(Text[i]));
+
+			for (int32 Out = Nodes[State].MatchLength > 0 ? State : Nodes[State].Output; Out != 0; Out = Nodes[Out].Output)
+			{
+				const FNode& Match = Nodes[Out];
+				const int32 Start = i - Match.MatchLength + 1;
+				const bool bStartOk = Start == WordStart || (Match.MatchFlags & AnyStart);
+				const bool bEndOk = i == WordEnd - 1 || (Match.MatchFlags & AnyEnd);
+				if (bStartOk && bEndOk && !Visitor(Start, i + 1))
+				{
+					return;
+				}
+			}
+		}
+
+		WordStart = WordEnd;
+	}
+}
+
+bool FChatProfanityFilter::ContainsMatch(const FString& Text) const
+{
+	if (NumPatterns == 0)
+	{
+		return false;
+	}
+
+	bool bFound = false;
+	ForEachMatch(Text, [&bFound](int32 Start, int32 End)
+	{
+		bFound = true;
+		return false;
+	});
+	return bFound;
+}
+
+bool FChatProfanityFilter::Mask(FString& Text, TCHAR MaskChar) const
+{
+	if (NumPatterns == 0)
+	{
+		return false;
+	}
+
+	// Collect first, the scan reads the unmasked text
+	TArray<TPair<int32, int32>, TInlineAllocator<4>> Ranges;
+	ForEachMatch(Text, [&Ranges](int32 Start, int32 End)
+	{
+		Ranges.Emplace(Start, End);
+		return true;
+	});
+
+	TArray<TCHAR, FString::AllocatorType>& Chars = Text.GetCharArray();
+	for (const TPair<int32, int32>& Range : Ranges)
+	{
+		for (int32 i = Range.Key; i < Range.Value; ++i)
+		{
+			Chars[i] = MaskChar;
+		}
+	}
+
+	return Ranges.Num() > 0;
+}
+
+EChatRejectReason FChatProfanityValidator::Validate(FChatModerationContext& Context) const
+{
+	// Clean messages are the common case, so scan once before deciding whether to copy or mask
+	if (!Filter->ContainsMatch(Context.Message.Content))
+	{
+		return EChatRejectReason::None;
+	}
+
+	switch (Mode)
+	{
+	case EChatProfanityFilterMode::Reject:
+		return EChatRejectReason::ProfanityDetected;
+
+	case EChatProfanityFilterMode::Mask:
+		Filter->Mask(Context.Message.Content);
+		break;
+
+	case EChatProfanityFilterMode::Flag:
+		Context.bFlagged = true;
+		break;
+	}
+
+	return EChatRejectReason::None;
+}
@@ -0,0 +1,152 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Moderation/ChatModerationPipeline.h"
+#include "ChatStats.h"
+#include "GameFramework/PlayerState.h"
+#include "Tasks/Task.h"
+
+void FChatModerationJob::Run()
+{
+	// Runs on the game thread or a worker, depending on where the job was launched
+	CHAT_SCOPE_CYCLE_COUNTER(STAT_ChatRunValidators);
+
+	StartTime = FPlatformTime::Seconds();
+	StageSeconds.Reset();
+
+	double StageStart = StartTime;
+	if (Validators)
+	{
+		for (const TSharedRef<const IChatMessageValidator>& Validator : *Validators)
+		{
+			Result = Validator->Validate(Context);
+
+			const double StageEnd = FPlatformTime::Seconds();
+			StageSeconds.Add(StageEnd - StageStart);
+			StageStart = StageEnd;
+
+			if (Result != EChatRejectReason::None)
+			{
+				break;
+			}
+		}
+	}
+
+	FinishTime = StageStart;
+	bComplete.store(true, std::memory_order_release);
+}
+
+void FChatModerationPipeline::Enqueue(const FChatMessage& Message, int32 SenderKey, const TSharedPtr<const FChatValidatorList>& Validators)
+{
+	check(IsInGameThread());
+
+	TSharedRef<FChatModerationJob> Job = MakeShared<FChatModerationJob>();
+	Job->Context.Message = Message;
+	Job->Sender = Message.Sender;
+	Job->WhisperTarget = Message.WhisperTarget;
+	Job->Validators = Validators;
+	Job->EnqueueTime = FPlatformTime::Seconds();
+
+	PendingBySender.FindOrAdd(SenderKey).Add(Job);
+	++QueueDepth;
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [Job]()
+	{
+		Job->Run();
+	});
+}
+
+void FChatModerationPipeline::RunSynchronously(FChatModerationJob& Job)
+{
+	Job.EnqueueTime = FPlatformTime::Seconds();
+	Job.Run();
+	RecordCompletion(Job, FPlatformTime::Seconds());
+}
+
+void FChatModerationPipeline::ReleaseCompleted(TFunctionRef<void(FChatModerationJob&)> Callback)
+{
+	check(IsInGameThread());
+
+	for (auto It = PendingBySender.CreateIterator(); It; ++It)
+	{
+		TArray<TSharedRef<FChatModerationJob>>& Jobs = It.Value();
+
+		// Only release from the front so a sender's messages keep their order
+		int32 NumReleased = 0;
+		while (NumReleased < Jobs.Num() && Jobs[NumReleased]->bComplete.load(std::memory_order_acquire))
+		{
+			FChatModerationJob& Job = Jobs[NumReleased].Get();
+			RecordCompletion(Job, FPlatformTime::Seconds());
+			Callback(Job);
+			++NumReleased;
+		}
+
+		if (NumReleased == Jobs.Num())
+		{
+			It.RemoveCurrent();
+		}
+		else if (NumReleased > 0)
+		{
+			Jobs.RemoveAt(0, NumReleased, EAllowShrinking::No);
+		}
+		QueueDepth -= NumReleased;
+	}
+}
+
+void FChatModerationPipeline::Flush(TFunctionRef<void(FChatModerationJob&)> Callback)
+{
+	while (HasPendingWork())
+	{
+		ReleaseCompleted(Callback);
+		if (HasPendingWork())
+		{
+			FPlatformProcess::Yield();
+		}
+	}
+}
+
+void FChatModerationPipeline::Reset()
+{
+	// In-flight tasks keep their job alive through their own reference and finish harmlessly
+	PendingBySender.Reset();
+	QueueDepth = 0;
+}
+
+FChatModerationStats FChatModerationPipeline::GetStats() const
+{
+	FChatModerationStats Result = Stats;
+	Result.QueueDepth = QueueDepth;
+	return Result;
+}
+
+void FChatModerationPipeline::RecordCompletion(const FChatModerationJob& Job, double ReleaseTime)
+{
+	++Stats.MessagesProcessed;
+	if (Job.Result != EChatRejectReason::None)
+	{
+		++Stats.MessagesRejected;
+	}
+
+	const double ValidationSeconds = Job.FinishTime - Job.StartTime;
+	TotalQueueWaitSeconds += Job.StartTime - Job.EnqueueTime;
+	TotalValidationSeconds += ValidationSeconds;
+	TotalReleaseWaitSeconds += ReleaseTime - Job.FinishTime;
+
+	const double ToAverageMs = 1000.0 / static_cast<double>(Stats.MessagesProcessed);
+	Stats.AverageQueueWaitMs = static_cast<float>(TotalQueueWaitSeconds * ToAverageMs);
+	Stats.AverageValidationMs = static_cast<float>(TotalValidationSeconds * ToAverageMs);
+	Stats.AverageReleaseWaitMs = static_cast<float>(TotalReleaseWaitSeconds * ToAverageMs);
+	Stats.MaxValidationMs = FMath::Max(Stats.MaxValidationMs, static_cast<float>(ValidationSeconds * 1000.0));
+
+	// Only the stages that ran; a rejection stops the chain early
+	if (Job.Validators)
+	{
+		for (int32 StageIndex = 0; StageIndex < Job.StageSeconds.Num(); ++StageIndex)
+		{
+			const FName StageName = (*Job.Validators)[StageIndex]->GetValidatorName();
+			FStageTotals& Totals = StageTotals.FindOrAdd(StageName);
+			Totals.Seconds += Job.StageSeconds[StageIndex];
+			++Totals.NumMessages;
+			Stats.AverageStageMs.Add(StageName, static_cast<float>(Totals.Seconds * 1000.0 / static_cast<double>(Totals.NumMessages)));
+		}
+	}
+}
@@ -0,0 +1,257 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Persistence/ChatArchive.h"
+#include "Persistence/ChatJournalFormat.h"
+#include "ChatSystem.h"
+#include "Algo/BinarySearch.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+
+namespace ChatArchiveFormat
+{
+	constexpr uint32 Magic = 0x41544843; // "CHTA"
+	constexpr uint32 Version = 1;
+}
+
+bool FChatArchive::Write(const FString& ArchivePath, TConstArrayView<uint8> Records)
+{
+	using namespace ChatJournalFormat;
+
+	FHeader NewHeader;
+	NewHeader.Magic = ChatArchiveFormat::Magic;
+	NewHeader.Version = ChatArchiveFormat::Version;
+	NewHeader.MinTicks = MAX_int64;
+	NewHeader.MaxTicks = MIN_int64;
+
+	// Collect block starts and per-block time bounds in one pass
+	TArray<FIndexEntry> NewIndex;
+	TArray<int64> BlockMinTicks;
+	const int64 RecordsSize = ForEachRecord(Records, [&](int64 Offset, const uint8* Payload, uint32)
+	{
+		int64 SequenceId = 0;
+		int64 Ticks = 0;
+		PeekRecordKeys(Payload, SequenceId, Ticks);
+
+		if (NewHeader.NumRecords % IndexInterval == 0)
+		{
+			FIndexEntry& Entry = NewIndex.AddDefaulted_GetRef();
+			Entry.SequenceId = SequenceId;
+			Entry.Offset = sizeof(FHeader) + Offset;
+			Entry.MaxTicksThroughBlock = Ticks;
+			BlockMinTicks.Add(Ticks);
+		}
+
+		FIndexEntry& Block = NewIndex.Last();
+		Block.MaxTicksThroughBlock = FMath::Max(Block.MaxTicksThroughBlock, Ticks);
+		BlockMinTicks.Last() = FMath::Min(BlockMinTicks.Last(), Ticks);
+
+		if (NewHeader.NumRecords == 0)
+		{
+			NewHeader.FirstSequenceId = SequenceId;
+		}
+		NewHeader.LastSequenceId = SequenceId;
+		NewHeader.MinTicks = FMath::Min(NewHeader.MinTicks, Ticks);
+		NewHeader.MaxTicks = FMath::Max(NewHeader.MaxTicks, Ticks);
+		++NewHeader.NumRecords;
+	});
+
+	if (NewHeader.NumRecords == 0)
+	{
+		return false;
+	}
+
+	// Turn the per-block bounds into a running max and a reverse running min
+	for (int32 Block = 1; Block < NewIndex.Num(); ++Block)
+	{
+		NewIndex[Block].MaxTicksThroughBlock = FMath::Max(NewIndex[Block].MaxTicksThroughBlock, NewIndex[Block - 1].MaxTicksThroughBlock);
+	}
+	int64 MinTicks = MAX_int64;
+	for (int32 Block = NewIndex.Num() - 1; Block >= 0; --Block)
+	{
+		MinTicks = FMath::Min(MinTicks, BlockMinTicks[Block]);
+		NewIndex[Block].MinTicksFromBlock = MinTicks;
+	}
+
+	const int64 IndexOffset = Align(static_cast<int64>(sizeof(FHeader)) + RecordsSize, 8);
+	NewHeader.IndexOffset = IndexOffset;
+	NewHeader.NumIndexEntries = NewIndex.Num();
+
+	const FString TempPath = ArchivePath + TEXT(".tmp");
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	{
+		TUniquePtr<IFileHandle> File(PlatformFile.OpenWrite(*TempPath));
+		const uint8 Padding[8] = {};
+		if (!File
+			|| !File->Write(reinterpret_cast<const uint8*>(&NewHeader), sizeof(FHeader))
+			|| !File->Write(Records.GetData(), RecordsSize)
+			|| !File->Write(Padding, IndexOffset - sizeof(FHeader) - RecordsSize)
+			|| !File->Write(reinterpret_cast<const uint8*>(NewIndex.GetData()), NewIndex.Num() * sizeof(FIndexEntry))
+			|| !File->Flush())
+		{
+			UE_LOG(LogChat, Warning, TEXT("Failed to write chat archive %s"), *TempPath);
+			File.Reset();
+			PlatformFile.DeleteFile(*TempPath);
+			return false;
+		}
+	}
+
+	if (!PlatformFile.MoveFile(*ArchivePath, *TempPath))
+	{
+		UE_LOG(LogChat, Warning, TEXT("Failed to move chat archive into place at %s"), *ArchivePath);
+		PlatformFile.DeleteFile(*TempPath);
+		return false;
+	}
+
+	return true;
+}
+
+TUniquePtr<FChatArchive> FChatArchive::Open(const FString& ArchivePath)
+{
+	TUniquePtr<FChatArchive> Archive(new FChatArchive());
+	Archive->MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*ArchivePath));
+	if (!Archive->MappedFile)
+	{
+		UE_LOG(LogChat, Warning, TEXT("Could not map chat archive %s"), *ArchivePath);
+		return nullptr;
+	}
+
+	const int64 FileSize = Archive->MappedFile->GetFileSize();
+	if (FileSize < static_cast<int64>(sizeof(FHeader)))
+	{
+		UE_LOG(LogChat, Warning, TEXT("Chat archive %s is too small"), *ArchivePath);
+		return nullptr;
+	}
+
+	Archive->MappedRegion.Reset(Archive->MappedFile->MapRegion(0, FileSize));
+	if (!Archive->MappedRegion)
+	{
+		UE_LOG(LogChat, Warning, TEXT("Could not map chat archive %s"), *ArchivePath);
+		return nullptr;
+	}
+
+	Archive->Data = Archive->MappedRegion->GetMappedPtr();
+	FMemory::Memcpy(&Archive->Header, Archive->Data, sizeof(FHeader));
+
+	const FHeader& Header = Archive->Header;
+	const int64 IndexSize = Header.NumIndexEntries * static_cast<int64>(sizeof(FIndexEntry));
+	if (Header.Magic != ChatArchiveFormat::Magic || Header.Version != ChatArchiveFormat::Version
+		|| Header.IndexOffset < static_cast<int64>(sizeof(FHeader)) || Header.IndexOffset % 8 != 0
+		|| Header.NumIndexEntries != FMath::DivideAndRoundUp(Header.NumRecords, IndexInterval)
+		|| Header.IndexOffset + IndexSize != FileSize)
+	{
+		UE_LOG(LogChat, Warning, TEXT("Chat archive %s is not a valid archive"), *ArchivePath);
+		return nullptr;
+	}
+
+	Archive->Index = MakeArrayView(reinterpret_cast<const FIndexEntry*>(Archive->Data + Header.IndexOffset), static_cast<int32>(Header.NumIndexEntries));
+	int64 PreviousOffset = static_cast<int64>(sizeof(FHeader)) - 1;
+	for (const FIndexEntry& Entry : Archive->Index)
+	{
+		if (Entry.Offset <= PreviousOffset || Entry.Offset >= Header.IndexOffset)
+		{
+			UE_LOG(LogChat, Warning, TEXT("Chat archive %s has a corrupt index"), *ArchivePath);
+			return nullptr;
+		}
+		PreviousOffset = Entry.Offset;
+	}
+
+	return Archive;
+}
+
+FChatArchive::~FChatArchive()
+{
+	// The region has to be unmapped before its file handle goes away
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+FString FChatArchive::MakeArchivePath(const FString& JournalPath, int64 FirstSequenceId)
+{
+	// Zero padded so a name sort is a sequence sort
+	return FPaths::Combine(FPaths::GetPath(JournalPath), FString::Printf(TEXT("%s.%020lld%s"), *FPaths::GetBaseFilename(JournalPath), FirstSequenceId, Extension));
+}
+
+void FChatArchive::FindArchives(const FString& JournalPath, TArray<FString>& OutArchivePaths)
+{
+	const FString Directory = FPaths::GetPath(JournalPath);
+
+	TArray<FString> FileNames;
+	IFileManager::Get().FindFiles(FileNames, *FPaths::Combine(Directory, FPaths::GetBaseFilename(JournalPath) + TEXT(".*") + Extension), true, false);
+	FileNames.Sort();
+
+	OutArchivePaths.Reset(FileNames.Num());
+	for (const FString& FileName : FileNames)
+	{
+		OutArchivePaths.Add(FPaths::Combine(Directory, FileName));
+	}
+}
+
+TConstArrayView<uint8> FChatArchive::GetBlockRecords(int32 Block) const
+{
+	const int64 Start = Index[Block].Offset;
+	const int64 End = Index.IsValidIndex(Block + 1) ? Index[Block + 1].Offset : Header.IndexOffset;
+	return MakeArrayView(Data + Start, static_cast<int32>(End - Start));
+}
+
+void FChatArchive::QueryBySequence(int64 FirstSequenceId, int64 LastSequenceId, int32 MaxResults, TArray<FChatMessage>& OutMessages) const
+{
+	if (MaxResults <= 0 || FirstSequenceId > LastSequenceId || LastSequenceId < Header.FirstSequenceId || FirstSequenceId > Header.LastSequenceId)
+	{
+		return;
+	}
+
+	// The block containing FirstSequenceId is the last one starting at or before it
+	const int32 FirstBlock = FMath::Max(0, Algo::UpperBoundBy(Index, FirstSequenceId, &FIndexEntry::SequenceId) - 1);
+	const int32 EndBlock = Algo::UpperBoundBy(Index, LastSequenceId, &FIndexEntry::SequenceId);
+
+	const int32 NumBefore = OutMessages.Num();
+	for (int32 Block = FirstBlock; Block < EndBlock && OutMessages.Num() - NumBefore < MaxResults; ++Block)
+	{
+		ChatJournalFormat::ForEachRecord(GetBlockRecords(Block), [&](int64, const uint8* Payload, uint32 PayloadSize)
+		{
+			int64 SequenceId = 0;
+			int64 Ticks = 0;
+			ChatJournalFormat::PeekRecordKeys(Payload, SequenceId, Ticks);
+
+			FChatMessage Message;
+			if (OutMessages.Num() - NumBefore < MaxResults && SequenceId >= FirstSequenceId && SequenceId <= LastSequenceId
+				&& ChatJournalFormat::DecodeRecord(Payload, PayloadSize, Message))
+			{
+				OutMessages.Add(MoveTemp(Message));
+			}
+		});
+	}
+}
+
+void FChatArchive::QueryByTime(const FDateTime& From, const FDateTime& To, int32 MaxResults, TArray<FChatMessage>& OutMessages) const
+{
+	const int64 FromTicks = From.GetTicks();
+	const int64 ToTicks = To.GetTicks();
+	if (MaxResults <= 0 || FromTicks >= ToTicks || ToTicks <= Header.MinTicks || FromTicks > Header.MaxTicks)
+	{
+		return;
+	}
+
+	// Blocks before FirstBlock only hold older messages, blocks from EndBlock on only newer ones
+	const int32 FirstBlock = Algo::LowerBoundBy(Index, FromTicks, &FIndexEntry::MaxTicksThroughBlock);
+	const int32 EndBlock = Algo::LowerBoundBy(Index, ToTicks, &FIndexEntry::MinTicksFromBlock);
+	const int32 NumBefore = OutMessages.Num();
+	for (int32 Block = FirstBlock; Block < EndBlock && OutMessages.Num() - NumBefore < MaxResults; ++Block)
+	{
+		ChatJournalFormat::ForEachRecord(GetBlockRecords(Block), [&](int64, const uint8* Payload, uint32 PayloadSize)
+		{
+			int64 SequenceId = 0;
+			int64 Ticks = 0;
+			ChatJournalFormat::PeekRecordKeys(Payload, SequenceId, Ticks);
+
+			FChatMessage Message;
+			if (OutMessages.Num() - NumBefore < MaxResults && Ticks >= FromTicks && Ticks < ToTicks
+				&& ChatJournalFormat::DecodeRecord(Payload, PayloadSize, Message))
+			{
+				OutMessages.Add(MoveTemp(Message));
+			}
+		});
+	}
+}
@@ -0,0 +1,287 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Persistence/ChatJournal.h"
+#include "Persistence/ChatJournalFormat.h"
+#include "Persistence/ChatArchive.h"
+#include "ChatSystem.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+TUniquePtr<FChatJournal> FChatJournal::Open(const FString& Path, int32 MaxMessagesToLoad, float FlushInterval, int64 MaxSegmentSize, TArray<FChatMessage>& OutRecentMessages)
+{
+	using namespace ChatJournalFormat;
+
+	OutRecentMessages.Reset();
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Path));
+
+	const FString IndexPath = GetIndexPath(Path);
+	TUniquePtr<IFileHandle> LogFile(PlatformFile.OpenWrite(*Path, true, true));
+	TUniquePtr<IFileHandle> IndexFile(PlatformFile.OpenWrite(*IndexPath, true, true));
+	if (!LogFile || !IndexFile)
+	{
+		UE_LOG(LogChat, Warning, TEXT("Could not open chat journal %s"), *Path);
+		return nullptr;
+	}
+
+	// Validate the header, starting a fresh log if it is missing or from another format
+	const int64 FileSize = LogFile->Size();
+	uint32 FileHeader[2] = {0, 0};
+	const bool bValidHeader = FileSize >= HeaderSize && LogFile->Seek(0) && LogFile->Read(reinterpret_cast<uint8*>(FileHeader), HeaderSize)
+		&& FileHeader[0] == Magic && FileHeader[1] == Version;
+
+	// A crash between archiving a segment and emptying the log leaves the archived records behind
+	bool bAlreadyArchived = false;
+	uint8 FirstRecord[RecordHeaderSize + sizeof(int64)];
+	if (bValidHeader && FileSize >= HeaderSize + static_cast<int64>(sizeof(FirstRecord)) && LogFile->Read(FirstRecord, sizeof(FirstRecord)))
+	{
+		int64 FirstSequenceId = 0;
+		FMemory::Memcpy(&FirstSequenceId, FirstRecord + RecordHeaderSize, sizeof(int64));
+		bAlreadyArchived = PlatformFile.FileExists(*FChatArchive::MakeArchivePath(Path, FirstSequenceId));
+	}
+
+	if (!bValidHeader || bAlreadyArchived)
+	{
+		if (bAlreadyArchived)
+		{
+			UE_LOG(LogChat, Log, TEXT("Chat journal %s was already archived, starting a new segment"), *Path);
+		}
+		else if (FileSize > 0)
+		{
+			UE_LOG(LogChat, Warning, TEXT("Chat journal %s is unreadable, starting a new one"), *Path);
+		}
+
+		const uint32 NewHeader[2] = {Magic, Version};
+		LogFile->Truncate(0);
+		LogFile->Seek(0);
+		LogFile->Write(reinterpret_cast<const uint8*>(NewHeader), HeaderSize);
+		IndexFile->Truncate(0);
+
+		return TUniquePtr<FChatJournal>(new FChatJournal(Path, MoveTemp(LogFile), MoveTemp(IndexFile), 0, HeaderSize, FlushInterval, MaxSegmentSize));
+	}
+
+	// Checkpoints that point past the end of the log were written after a torn batch; ignore them
+	TArray<FCheckpoint> Checkpoints;
+	{
+		TArray<uint8> IndexBuffer;
+		const int64 IndexSize = IndexFile->Size() - IndexFile->Size() % CheckpointSize;
+		if (IndexSize > 0 && ReadRange(*IndexFile, 0, IndexSize, IndexBuffer))
+		{
+			FMemoryReader IndexReader(IndexBuffer);
+			while (!IndexReader.AtEnd())
+			{
+				FCheckpoint Checkpoint;
+				IndexReader << Checkpoint.RecordNumber << Checkpoint.Offset;
+				if (Checkpoint.RecordNumber != Checkpoints.Num() * CheckpointInterval || Checkpoint.Offset < HeaderSize || Checkpoint.Offset >= FileSize)
+				{
+					break;
+				}
+				Checkpoints.Add(Checkpoint);
+			}
+		}
+	}
+
+	// Read from far enough back to cover MaxMessagesToLoad plus the partial block after the last checkpoint
+	const int32 NumBlocksToLoad = FMath::DivideAndRoundUp(FMath::Max(0, MaxMessagesToLoad), static_cast<int32>(CheckpointInterval)) + 1;
+	const int32 FirstCheckpoint = FMath::Max(0, Checkpoints.Num() - NumBlocksToLoad);
+	const int64 ReadOffset = Checkpoints.IsValidIndex(FirstCheckpoint) ? Checkpoints[FirstCheckpoint].Offset : HeaderSize;
+	const int64 FirstRecordNumber = Checkpoints.IsValidIndex(FirstCheckpoint) ? Checkpoints[FirstCheckpoint].RecordNumber : 0;
+
+	TArray<uint8> Tail;
+	if (!ReadRange(*LogFile, ReadOffset, FileSize - ReadOffset, Tail))
+	{
+		UE_LOG(LogChat, Warning, TEXT("Could not read chat journal %s"), *Path);
+		return nullptr;
+	}
+
+	// First pass only checks framing and CRCs; only the newest records get decoded
+	int64 NumTailRecords = 0;
+	const int64 ValidTailSize = ForEachRecord(Tail, [&NumTailRecords](int64, const uint8*, uint32) { ++NumTailRecords; });
+
+	const int64 FirstToDecode = NumTailRecords - FMath::Min<int64>(NumTailRecords, FMath::Max(0, MaxMessagesToLoad));
+	OutRecentMessages.Reserve(static_cast<int32>(NumTailRecords - FirstToDecode));
+	int64 RecordIndex = 0;
+	ForEachRecord(Tail, [&](int64, const uint8* Payload, uint32 PayloadSize)
+	{
+		if (RecordIndex++ >= FirstToDecode)
+		{
+			FChatMessage Message;
+			if (DecodeRecord(Payload, PayloadSize, Message))
+			{
+				OutRecentMessages.Add(MoveTemp(Message));
+			}
+		}
+	});
+
+	const int64 NumRecords = FirstRecordNumber + NumTailRecords;
+	const int64 LogSize = ReadOffset + ValidTailSize;
+
+	// Cut off a torn tail and any checkpoints past it, then append from there
+	if (LogSize < FileSize)
+	{
+		UE_LOG(LogChat, Warning, TEXT("Chat journal %s had %lld trailing bytes that were not a complete record, discarding them"), *Path, FileSize - LogSize);
+		LogFile->Truncate(LogSize);
+	}
+	const int32 NumValidCheckpoints = static_cast<int32>(FMath::DivideAndRoundUp(NumRecords, CheckpointInterval));
+	IndexFile->Truncate(FMath::Min(Checkpoints.Num(), NumValidCheckpoints) * CheckpointSize);
+	LogFile->SeekFromEnd(0);
+	IndexFile->SeekFromEnd(0);
+
+	// Checkpoints that were lost (e.g. a torn index) are not rewritten; loading just reads a bit more of the log
+	TUniquePtr<FChatJournal> Journal(new FChatJournal(Path, MoveTemp(LogFile), MoveTemp(IndexFile), NumRecords, LogSize, FlushInterval, MaxSegmentSize));
+	UE_LOG(LogChat, Log, TEXT("Chat journal %s opened with %lld records, %d restored"), *Path, NumRecords, OutRecentMessages.Num());
+	return Journal;
+}
+
+FChatJournal::FChatJournal(const FString& InPath, TUniquePtr<IFileHandle> InLogFile, TUniquePtr<IFileHandle> InIndexFile, int64 InNumRecords, int64 InLogSize, float FlushInterval, int64 InMaxSegmentSize)
+	: Path(InPath)
+	, LogFile(MoveTemp(InLogFile))
+	, IndexFile(MoveTemp(InIndexFile))
+	, NumRecordsWritten(InNumRecords)
+	, LogSize(InLogSize)
+	, FlushIntervalMs(static_cast<uint32>(FMath::Max(0.01f, FlushInterval) * 1000.0f))
+	, MaxSegmentSize(FMath::Max<int64>(0, InMaxSegmentSize))
+	, RotateAtSize(MaxSegmentSize)
+{
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("ChatJournalWriter"), 0, TPri_BelowNormal);
+}
+
+FChatJournal::~FChatJournal()
+{
+	if (Thread)
+	{
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+	}
+	else
+	{
+		// No writer thread (e.g. single-threaded platform), write here
+		WriteQueuedRecords();
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+void FChatJournal::Append(const FChatMessage& Message)
+{
+	TArray<uint8> Record;
+	ChatJournalFormat::EncodeRecord(Message, Record);
+
+	const int64 RecordSize = Record.Num();
+	PendingRecords.Enqueue(MoveTemp(Record));
+
+	if (PendingBytes.fetch_add(RecordSize) + RecordSize >= ChatJournalFormat::EarlyFlushBytes)
+	{
+		WakeEvent->Trigger();
+	}
+}
+
+uint32 FChatJournal::Run()
+{
+	while (!bStopping)
+	{
+		WakeEvent->Wait(FlushIntervalMs);
+		WriteQueuedRecords();
+	}
+
+	// Final drain after Stop
+	WriteQueuedRecords();
+	return 0;
+}
+
+void FChatJournal::Stop()
+{
+	bStopping = true;
+	WakeEvent->Trigger();
+}
+
+void FChatJournal::WriteQueuedRecords()
+{
+	using namespace ChatJournalFormat;
+
+	TArray<uint8> Batch;
+	TArray<uint8> IndexBatch;
+	FMemoryWriter IndexWriter(IndexBatch);
+
+	TArray<uint8> Record;
+	while (PendingRecords.Dequeue(Record))
+	{
+		if (NumRecordsWritten % CheckpointInterval == 0)
+		{
+			int64 RecordNumber = NumRecordsWritten;
+			int64 Offset = LogSize + Batch.Num();
+			IndexWriter << RecordNumber << Offset;
+		}
+
+		Batch.Append(Record);
+		++NumRecordsWritten;
+	}
+
+	if (Batch.Num() == 0)
+	{
+		return;
+	}
+
+	// Log first, so a checkpoint never points at data that was not written
+	if (!LogFile->Write(Batch.GetData(), Batch.Num()))
+	{
+		UE_LOG(LogChat, Warning, TEXT("Failed to write %d bytes to chat journal %s"), Batch.Num(), *Path);
+	}
+	LogFile->Flush();
+	LogSize += Batch.Num();
+
+	if (IndexBatch.Num() > 0)
+	{
+		IndexFile->Write(IndexBatch.GetData(), IndexBatch.Num());
+		IndexFile->Flush();
+	}
+
+	PendingBytes.fetch_sub(Batch.Num());
+
+	if (MaxSegmentSize > 0 && LogSize >= RotateAtSize)
+	{
+		RotateSegment();
+	}
+}
+
+void FChatJournal::RotateSegment()
+{
+	using namespace ChatJournalFormat;
+
+	TArray<uint8> Segment;
+	const bool bRead = ReadRange(*LogFile, HeaderSize, LogSize - HeaderSize, Segment);
+	LogFile->SeekFromEnd(0);
+
+	int64 FirstSequenceId = 0;
+	int64 FirstTicks = 0;
+	if (bRead && Segment.Num() >= RecordHeaderSize + 2 * static_cast<int32>(sizeof(int64)))
+	{
+		PeekRecordKeys(Segment.GetData() + RecordHeaderSize, FirstSequenceId, FirstTicks);
+	}
+
+	const FString ArchivePath = FChatArchive::MakeArchivePath(Path, FirstSequenceId);
+	if (!bRead || !FChatArchive::Write(ArchivePath, Segment))
+	{
+		// Keep appending to this segment and try again once it has grown by another segment
+		UE_LOG(LogChat, Warning, TEXT("Could not archive chat journal %s, will retry later"), *Path);
+		RotateAtSize = LogSize + MaxSegmentSize;
+		return;
+	}
+
+	LogFile->Truncate(HeaderSize);
+	LogFile->SeekFromEnd(0);
+	IndexFile->Truncate(0);
+	IndexFile->Seek(0);
+	NumRecordsWritten = 0;
+	LogSize = HeaderSize;
+	RotateAtSize = MaxSegmentSize;
+
+	UE_LOG(LogChat, Log, TEXT("Chat journal %s archived to %s"), *Path, *ArchivePath);
+}
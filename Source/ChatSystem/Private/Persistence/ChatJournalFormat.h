@@ -0,0 +1,132 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/Crc.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Data/ChatMessage.h"
+
+/**
+ * Record format shared by journal segments and archives
+ * A record is [payload size][payload CRC][payload], the payload starting with the sequence id and timestamp
+ */
+namespace ChatJournalFormat
+{
+	constexpr uint32 Magic = 0x4A544843; // "CHTJ"
+	constexpr uint32 Version = 1;
+	constexpr int64 HeaderSize = 8;
+
+	/** Payload size and CRC in front of every record */
+	constexpr int64 RecordHeaderSize = 8;
+
+	/** Anything larger is treated as corruption */
+	constexpr uint32 MaxPayloadSize = 64 * 1024;
+
+	/** Wake the writer before the flush interval once this much is queued */
+	constexpr int64 EarlyFlushBytes = 256 * 1024;
+
+	/** One index entry: record number and log offset, both int64 */
+	constexpr int64 CheckpointSize = 16;
+
+	struct FCheckpoint
+	{
+		int64 RecordNumber = 0;
+		int64 Offset = 0;
+	};
+
+	inline FString GetIndexPath(const FString& LogPath)
+	{
+		return LogPath + TEXT(".idx");
+	}
+
+	inline void EncodeRecord(const FChatMessage& Message, TArray<uint8>& OutRecord)
+	{
+		OutRecord.Reset();
+		OutRecord.AddZeroed(RecordHeaderSize);
+
+		FMemoryWriter Writer(OutRecord);
+		Writer.Seek(RecordHeaderSize);
+
+		int64 SequenceId = Message.SequenceId;
+		int64 TimestampTicks = Message.Timestamp.GetTicks();
+		uint8 Channel = static_cast<uint8>(Message.Channel);
+		int32 CustomChannelId = Message.CustomChannelId;
+		FColor Color = Message.MessageColor.QuantizeRound();
+		FString SenderName = Message.SenderName;
+		FString Content = Message.Content;
+		Writer << SequenceId << TimestampTicks << Channel << CustomChannelId << Color << SenderName << Content;
+
+		uint32 PayloadSize = static_cast<uint32>(OutRecord.Num() - RecordHeaderSize);
+		uint32 Crc = FCrc::MemCrc32(OutRecord.GetData() + RecordHeaderSize, PayloadSize);
+		Writer.Seek(0);
+		Writer << PayloadSize << Crc;
+	}
+
+	/** Read just the sequence id and timestamp at the front of a payload */
+	inline void PeekRecordKeys(const uint8* Payload, int64& OutSequenceId, int64& OutTimestampTicks)
+	{
+		FMemory::Memcpy(&OutSequenceId, Payload, sizeof(int64));
+		FMemory::Memcpy(&OutTimestampTicks, Payload + sizeof(int64), sizeof(int64));
+	}
+
+	inline bool DecodeRecord(const uint8* Payload, uint32 PayloadSize, FChatMessage& OutMessage)
+	{
+		TArrayView<const uint8> View(Payload, PayloadSize);
+		FMemoryReaderView Reader(View);
+
+		int64 TimestampTicks = 0;
+		uint8 Channel = 0;
+		FColor Color;
+		Reader << OutMessage.SequenceId << TimestampTicks << Channel << OutMessage.CustomChannelId << Color << OutMessage.SenderName << OutMessage.Content;
+		if (Reader.IsError() || Channel >= NumChatChannels)
+		{
+			return false;
+		}
+
+		OutMessage.Sender = nullptr;
+		OutMessage.WhisperTarget = nullptr;
+		OutMessage.Timestamp = FDateTime(TimestampTicks);
+		OutMessage.Channel = static_cast<EChatChannel>(Channel);
+		OutMessage.MessageColor = Color.ReinterpretAsLinear();
+		return true;
+	}
+
+	/**
+	 * Walk the records in a buffer, stopping at the first one that is torn or fails its CRC
+	 * @param Visitor Called with (Offset, Payload, PayloadSize) for each valid record
+	 * @return Number of bytes that hold complete, valid records
+	 */
+	template<typename FunctorType>
+	int64 ForEachRecord(TConstArrayView<uint8> Buffer, FunctorType&& Visitor)
+	{
+		int64 Offset = 0;
+		while (Offset + RecordHeaderSize <= Buffer.Num())
+		{
+			uint32 PayloadSize = 0;
+			uint32 Crc = 0;
+			FMemory::Memcpy(&PayloadSize, Buffer.GetData() + Offset, sizeof(uint32));
+			FMemory::Memcpy(&Crc, Buffer.GetData() + Offset + sizeof(uint32), sizeof(uint32));
+
+			const uint8* Payload = Buffer.GetData() + Offset + RecordHeaderSize;
+			if (PayloadSize < 2 * sizeof(int64) || PayloadSize > MaxPayloadSize || Offset + RecordHeaderSize + PayloadSize > Buffer.Num()
+				|| FCrc::MemCrc32(Payload, PayloadSize) != Crc)
+			{
+				break;
+			}
+
+			Visitor(Offset, Payload, PayloadSize);
+			Offset += RecordHeaderSize + PayloadSize;
+		}
+
+		return Offset;
+	}
+
+	inline bool ReadRange(IFileHandle& File, int64 Offset, int64 Size, TArray<uint8>& OutBuffer)
+	{
+		OutBuffer.SetNumUninitialized(Size);
+		return File.Seek(Offset) && File.Read(OutBuffer.GetData(), Size);
+	}
+}
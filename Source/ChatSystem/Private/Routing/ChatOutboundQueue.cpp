@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Routing/ChatOutboundQueue.h"
+
+namespace ChatOutboundQueue
+{
+	/** Upper bounds in seconds of all but the last age bucket */
+	constexpr double AgeBucketBounds[FChatOutboundQueue::NumAgeBuckets - 1] = {0.05, 0.1, 0.25, 0.5, 1.0, 2.0, 5.0};
+
+	/** Compact a lane once this many sent entries sit at its front */
+	constexpr int32 MinCompactCount = 32;
+
+	int32 GetAgeBucket(double Age)
+	{
+		int32 Bucket = 0;
+		while (Bucket < FChatOutboundQueue::NumAgeBuckets - 1 && Age >= AgeBucketBounds[Bucket])
+		{
+			++Bucket;
+		}
+		return Bucket;
+	}
+}
+
+FChatOutboundQueue::FChatOutboundQueue()
+{
+	Lanes.SetNum(NumChatChannels);
+	Stats.MessagesExpired.SetNumZeroed(NumChatChannels);
+	Stats.QueuedAgeHistogram.SetNumZeroed(NumAgeBuckets);
+}
+
+int32 FChatOutboundQueue::GetPriority(EChatChannel Channel)
+{
+	switch (Channel)
+	{
+	case EChatChannel::System:		return 0;
+	case EChatChannel::Whisper:		return 1;
+	case EChatChannel::Team:		return 2;
+	case EChatChannel::Custom:		return 3;
+	case EChatChannel::Proximity:	return 4;
+	default:						return 5;
+	}
+}
+
+void FChatOutboundQueue::Enqueue(const FChatMessage& Message, double Now)
+{
+	FChatOutboundLane& Lane = Lanes[GetPriority(Message.Channel)];
+	Lane.Messages.Add(Message);
+	Lane.QueueTimes.Add(Now);
+
+	++Stats.QueueDepth;
+	Stats.PeakQueueDepth = FMath::Max(Stats.PeakQueueDepth, Stats.QueueDepth);
+}
+
+void FChatOutboundQueue::PopFront(FChatOutboundLane& Lane)
+{
+	++Lane.Head;
+	if (Lane.Head == Lane.Messages.Num())
+	{
+		Lane.Messages.Reset();
+		Lane.QueueTimes.Reset();
+		Lane.Head = 0;
+	}
+	else if (Lane.Head >= ChatOutboundQueue::MinCompactCount && Lane.Head * 2 >= Lane.Messages.Num())
+	{
+		Lane.Messages.RemoveAt(0, Lane.Head, EAllowShrinking::No);
+		Lane.QueueTimes.RemoveAt(0, Lane.Head, EAllowShrinking::No);
+		Lane.Head = 0;
+	}
+}
+
+int32 FChatOutboundQueue::Drain(double Now, const FChatSettings& Settings, bool bIgnoreBudget, TFunctionRef<void(const FChatMessage&)> Send)
+{
+	if (Stats.QueueDepth == 0)
+	{
+		return 0;
+	}
+
+	// Refill for the elapsed time, holding at most one second's worth
+	const double Rate = Settings.OutboundBytesPerSecond;
+	const bool bBudgeted = Rate > 0.0 && !bIgnoreBudget;
+	Budget = LastRefillTime < 0.0 ? Rate : FMath::Min(Rate, Budget + (Now - LastRefillTime) * Rate);
+	LastRefillTime = Now;
+
+	int32 NumRemoved = 0;
+	for (FChatOutboundLane& Lane : Lanes)
+	{
+		if (Lane.Num() == 0)
+		{
+			continue;
+		}
+
+		// Lanes hold a single channel and are FIFO, so stale messages are all at the front
+		const EChatChannel Channel = Lane.Messages[Lane.Head].Channel;
+		if (const float* Lifetime = Settings.OutboundMessageLifetimes.Find(Channel))
+		{
+			while (Lane.Num() > 0 && Now - Lane.QueueTimes[Lane.Head] > *Lifetime)
+			{
+				++Stats.MessagesExpired[static_cast<int32>(Channel)];
+				PopFront(Lane);
+				++NumRemoved;
+			}
+		}
+
+		while (Lane.Num() > 0 && (!bBudgeted || Budget > 0.0))
+		{
+			const FChatMessage& Message = Lane.Messages[Lane.Head];
+			const int32 EstimatedBytes = EstimateWireSize(Message);
+			Send(Message);
+
+			Budget -= EstimatedBytes;
+			++Stats.MessagesSent;
+			Stats.BytesSent += EstimatedBytes;
+			++Stats.QueuedAgeHistogram[ChatOutboundQueue::GetAgeBucket(Now - Lane.QueueTimes[Lane.Head])];
+
+			PopFront(Lane);
+			++NumRemoved;
+		}
+	}
+
+	Stats.QueueDepth -= NumRemoved;
+	return NumRemoved;
+}
@@ -0,0 +1,74 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Routing/ChatReplicationInfo.h"
+#include "ChatComponent.h"
+#include "ChatSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Net/UnrealNetwork.h"
+
+AChatReplicationInfo::AChatReplicationInfo()
+{
+	bReplicates = true;
+	bAlwaysRelevant = true;
+
+	// Messages go through RPCs; the only property is TeamId, which never changes
+	SetNetUpdateFrequency(1.0f);
+}
+
+void AChatReplicationInfo::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AChatReplicationInfo, TeamId);
+}
+
+void AChatReplicationInfo::MulticastReceiveMessage_Implementation(const FChatMessage& Message)
+{
+	DeliverToLocalPlayers(Message);
+}
+
+void AChatReplicationInfo::MulticastReceiveMessageUnreliable_Implementation(const FChatMessage& Message)
+{
+	DeliverToLocalPlayers(Message);
+}
+
+void AChatReplicationInfo::MulticastReceiveMessageBatchUnreliable_Implementation(const TArray<FChatMessage>& Messages)
+{
+	for (const FChatMessage& Message : Messages)
+	{
+		DeliverToLocalPlayers(Message);
+	}
+}
+
+void AChatReplicationInfo::DeliverToLocalPlayers(const FChatMessage& Message) const
+{
+	// Team members on the server are sent to directly, the host may not be one of them
+	UWorld* World = GetWorld();
+	if (!World || (TeamId != INDEX_NONE && HasAuthority()))
+	{
+		return;
+	}
+
+	// Also runs on a listen server, where it reaches the host; a dedicated server has no local players
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (!PlayerController || !PlayerController->IsLocalController() || !PlayerController->PlayerState)
+		{
+			continue;
+		}
+
+		// Backs up the server's connection filter: a team relay that reached the wrong client says nothing there
+		if (TeamId != INDEX_NONE && UChatSubsystem::QueryTeamId(PlayerController->PlayerState) != TeamId)
+		{
+			continue;
+		}
+
+		if (UChatComponent* Component = PlayerController->PlayerState->FindComponentByClass<UChatComponent>())
+		{
+			Component->HandleBroadcastMessage(Message);
+		}
+	}
+}
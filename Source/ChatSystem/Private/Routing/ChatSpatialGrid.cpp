@@ -0,0 +1,36 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Routing/ChatSpatialGrid.h"
+#include "ChatComponent.h"
+
+void FChatSpatialGrid::Reset(float InCellSize)
+{
+	InvCellSize = 1.0f / FMath::Max(InCellSize, 1.0f);
+
+	// Drop the cell map entirely if it is mostly empty cells left behind by moving players,
+	// otherwise keep the per-cell allocations for the next build
+	if (Cells.Num() > FMath::Max(64, NumEntries * 4))
+	{
+		Cells.Reset();
+	}
+	else
+	{
+		for (TPair<FIntPoint, TArray<FEntry>>& Pair : Cells)
+		{
+			Pair.Value.Reset();
+		}
+	}
+
+	NumEntries = 0;
+}
+
+void FChatSpatialGrid::Add(UChatComponent* Component, const FVector& Location)
+{
+	if (!Component)
+	{
+		return;
+	}
+
+	Cells.FindOrAdd(GetCell(Location)).Add({ Component, Location });
+	++NumEntries;
+}
@@ -0,0 +1,148 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ChatTestWorld.h"
+#include "ChatComponent.h"
+#include "ChatSubsystem.h"
+#include "GameFramework/PlayerState.h"
+
+namespace ChatDeliveryPolicyTests
+{
+	/** Global is sent twice, System once unreliably, everything else reliably */
+	void UseDeliveryPolicies(UChatSubsystem& Subsystem, bool bBatching)
+	{
+		FChatSettings Settings = Subsystem.GetChatSettings();
+		Settings.bAsyncModeration = false;
+		Settings.RateLimit.MessagesPerSecond = 100000.0f;
+		Settings.RateLimit.Burst = 100000;
+		Settings.bEnableMessageBatching = bBatching;
+		Settings.MaxBatchSize = 1000;
+		Settings.MaxBatchBytes = 1 << 20;
+		Settings.ChannelDeliveryPolicies.Add(EChatChannel::Global, EChatDeliveryPolicy::UnreliableRedundant);
+		Settings.ChannelDeliveryPolicies.Add(EChatChannel::System, EChatDeliveryPolicy::Unreliable);
+		Subsystem.SetChatSettings(Settings);
+	}
+
+	EChatRejectReason Send(UChatSubsystem& Subsystem, UChatComponent* Sender, EChatChannel Channel, UChatComponent* Target = nullptr)
+	{
+		FChatMessage Message;
+		Message.Sender = Cast<APlayerState>(Sender->GetOwner());
+		Message.WhisperTarget = Target ? Cast<APlayerState>(Target->GetOwner()) : nullptr;
+		Message.Channel = Channel;
+		Message.Content = TEXT("hello");
+		return Subsystem.SubmitMessage(Message, false);
+	}
+
+	/** Messages a component received and kept on a channel */
+	int64 NumReceived(const UChatComponent* Component, EChatChannel Channel)
+	{
+		int64 First = 0;
+		int64 End = 0;
+		Component->GetStoredMessageBounds(Channel, First, End);
+		return End - First;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatDeliveryPolicyUnbatchedTest, "ChatSystem.DeliveryPolicy.Unbatched", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatDeliveryPolicyUnbatchedTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatDeliveryPolicyTests;
+
+	ChatTests::FChatTestWorld TestWorld;
+	UChatSubsystem* Subsystem = TestWorld.GetSubsystem();
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+	UseDeliveryPolicies(*Subsystem, false);
+
+	UChatComponent* A = TestWorld.SpawnPlayingPlayer();
+	UChatComponent* B = TestWorld.SpawnPlayingPlayer();
+	const FChatBatchingStats Before = Subsystem->GetBatchingStats();
+
+	// Redundant: sent at once, then again with the next flush
+	TestTrue(TEXT("Global accepted"), Send(*Subsystem, A, EChatChannel::Global) == EChatRejectReason::None);
+	TestEqual(TEXT("A received global"), NumReceived(A, EChatChannel::Global), 1LL);
+	TestEqual(TEXT("B received global"), NumReceived(B, EChatChannel::Global), 1LL);
+	TestEqual(TEXT("One unreliable RPC each"), Subsystem->GetBatchingStats().UnreliableRPCsSent - Before.UnreliableRPCsSent, 2LL);
+
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("A copy each on flush"), Subsystem->GetBatchingStats().RedundantCopiesSent - Before.RedundantCopiesSent, 2LL);
+	TestEqual(TEXT("Copy is not shown again"), NumReceived(B, EChatChannel::Global), 1LL);
+	TestEqual(TEXT("Copy counted as a duplicate"), B->GetDuplicateMessageCount(), 1LL);
+
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("Only one copy is sent"), Subsystem->GetBatchingStats().RedundantCopiesSent - Before.RedundantCopiesSent, 2LL);
+
+	// Unreliable: sent once, no copy
+	Subsystem->BroadcastSystemMessage(TEXT("system"));
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("System received once"), NumReceived(B, EChatChannel::System), 1LL);
+	TestEqual(TEXT("No copy of unreliable messages"), B->GetDuplicateMessageCount(), 1LL);
+
+	// Reliable: straight through, nothing held back without a saturated connection
+	TestTrue(TEXT("Whisper accepted"), Send(*Subsystem, A, EChatChannel::Whisper, B) == EChatRejectReason::None);
+	TestEqual(TEXT("Whisper received"), NumReceived(B, EChatChannel::Whisper), 1LL);
+	TestEqual(TEXT("Sender sees its whisper"), NumReceived(A, EChatChannel::Whisper), 1LL);
+	TestEqual(TEXT("Nothing deferred"), Subsystem->GetBatchingStats().ReliableMessagesDeferred - Before.ReliableMessagesDeferred, 0LL);
+
+	// Copies are still recognized when many sequence ids were used in between
+	Send(*Subsystem, A, EChatChannel::Global);
+	for (int32 i = 0; i < 200; ++i)
+	{
+		Send(*Subsystem, A, EChatChannel::Whisper, B);
+	}
+	Send(*Subsystem, A, EChatChannel::Global);
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("Both globals shown once"), NumReceived(B, EChatChannel::Global), 3LL);
+	TestEqual(TEXT("Both copies dropped"), B->GetDuplicateMessageCount(), 3LL);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatDeliveryPolicyBatchedTest, "ChatSystem.DeliveryPolicy.Batched", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatDeliveryPolicyBatchedTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatDeliveryPolicyTests;
+
+	ChatTests::FChatTestWorld TestWorld;
+	UChatSubsystem* Subsystem = TestWorld.GetSubsystem();
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+	UseDeliveryPolicies(*Subsystem, true);
+
+	UChatComponent* A = TestWorld.SpawnPlayingPlayer();
+	UChatComponent* B = TestWorld.SpawnPlayingPlayer();
+
+	Send(*Subsystem, A, EChatChannel::Global);
+	Subsystem->BroadcastSystemMessage(TEXT("system"));
+	Send(*Subsystem, A, EChatChannel::Whisper, B);
+	TestEqual(TEXT("Batched messages wait for the flush"), NumReceived(B, EChatChannel::Global) + NumReceived(B, EChatChannel::System) + NumReceived(B, EChatChannel::Whisper), 0LL);
+
+	// Every policy goes out with the flush
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("Global received"), NumReceived(B, EChatChannel::Global), 1LL);
+	TestEqual(TEXT("System received"), NumReceived(B, EChatChannel::System), 1LL);
+	TestEqual(TEXT("Whisper received"), NumReceived(B, EChatChannel::Whisper), 1LL);
+	TestEqual(TEXT("Nothing duplicated yet"), B->GetDuplicateMessageCount(), 0LL);
+
+	// The redundant message goes out once more with the following flush
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("Copy is not shown again"), NumReceived(B, EChatChannel::Global), 1LL);
+	TestEqual(TEXT("Copy counted as a duplicate"), B->GetDuplicateMessageCount(), 1LL);
+	TestEqual(TEXT("Sender gets its copy too"), A->GetDuplicateMessageCount(), 1LL);
+
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("Only one copy is sent"), B->GetDuplicateMessageCount(), 1LL);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,79 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ChatTestWorld.h"
+#include "ChatSubsystem.h"
+#include "Persistence/ChatJournal.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace ChatJournalSettingsTests
+{
+	const TCHAR* TestDirectory = TEXT("Automation/ChatJournalSettings");
+
+	/** Contents of every message in a journal, oldest first */
+	TArray<FString> ReadJournal(const FString& RelativePath)
+	{
+		TArray<FChatMessage> Messages;
+		FChatJournal::Open(FPaths::Combine(FPaths::ProjectSavedDir(), RelativePath), 100, 1.0f, 0, Messages);
+
+		TArray<FString> Contents;
+		for (const FChatMessage& Message : Messages)
+		{
+			Contents.Add(Message.Content);
+		}
+		return Contents;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatJournalSettingsChangeTest, "ChatSystem.Journal.SettingsChange", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatJournalSettingsChangeTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatJournalSettingsTests;
+
+	const FString Directory = FPaths::Combine(FPaths::ProjectSavedDir(), TestDirectory);
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+	const FString PathA = FPaths::Combine(TestDirectory, TEXT("A.chatlog"));
+	const FString PathB = FPaths::Combine(TestDirectory, TEXT("B.chatlog"));
+
+	{
+		ChatTests::FChatTestWorld TestWorld;
+		UChatSubsystem* Subsystem = TestWorld.GetSubsystem();
+		if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+		{
+			return false;
+		}
+
+		// Messages sent while the journal is off must not keep it off
+		Subsystem->BroadcastSystemMessage(TEXT("before"));
+
+		FChatSettings Settings = Subsystem->GetChatSettings();
+		Settings.bEnableJournal = true;
+		Settings.JournalPath = PathA;
+		Subsystem->SetChatSettings(Settings);
+		Subsystem->BroadcastSystemMessage(TEXT("one"));
+
+		// A new path closes the open journal and starts writing the new one
+		Settings.JournalPath = PathB;
+		Subsystem->SetChatSettings(Settings);
+		Subsystem->BroadcastSystemMessage(TEXT("two"));
+
+		// Turning it off stops writing
+		Settings.bEnableJournal = false;
+		Subsystem->SetChatSettings(Settings);
+		Subsystem->BroadcastSystemMessage(TEXT("three"));
+
+		TestEqual(TEXT("Enabling after the first message opens the journal"), ReadJournal(PathA), TArray<FString>({ TEXT("one") }));
+		TestEqual(TEXT("Changing the path reopens the journal there"), ReadJournal(PathB), TArray<FString>({ TEXT("two") }));
+	}
+
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
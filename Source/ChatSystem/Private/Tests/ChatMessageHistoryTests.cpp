@@ -0,0 +1,129 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Data/ChatMessageHistory.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ChatMessageHistoryTests
+{
+	/** Add messages with consecutive sequence ids First..Last */
+	void AddRange(FChatMessageHistory& History, int64 First, int64 Last)
+	{
+		for (int64 Sequence = First; Sequence <= Last; ++Sequence)
+		{
+			FChatMessage Message;
+			Message.SequenceId = Sequence;
+			Message.Content = FString::Printf(TEXT("Message %lld"), Sequence);
+			History.Add(MoveTemp(Message));
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatMessageHistoryWraparoundTest, "ChatSystem.History.Wraparound", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatMessageHistoryWraparoundTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatMessageHistoryTests;
+
+	FChatMessageHistory History;
+	History.SetCapacity(4);
+	AddRange(History, 1, 3);
+	TestEqual(TEXT("Not yet full"), History.Num(), 3);
+	TestEqual(TEXT("Oldest before wrapping"), History[0].SequenceId, 1LL);
+
+	// Wraps more than once around the storage
+	AddRange(History, 4, 10);
+	TestEqual(TEXT("Num is capped at capacity"), History.Num(), 4);
+	for (int32 Index = 0; Index < History.Num(); ++Index)
+	{
+		TestEqual(FString::Printf(TEXT("Logical index %d is in order"), Index), History[Index].SequenceId, 7LL + Index);
+	}
+	TestEqual(TEXT("Last is the newest"), History.Last().SequenceId, 10LL);
+	TestEqual(TEXT("Content moved along with the id"), History.Last().Content, FString(TEXT("Message 10")));
+
+	// Shrinking a wrapped buffer keeps the newest messages
+	History.SetCapacity(2);
+	TestEqual(TEXT("Shrunk to the new capacity"), History.Num(), 2);
+	TestEqual(TEXT("Oldest after shrinking"), History[0].SequenceId, 9LL);
+	TestEqual(TEXT("Newest after shrinking"), History[1].SequenceId, 10LL);
+
+	// Growing keeps everything and continues in order
+	History.SetCapacity(5);
+	AddRange(History, 11, 14);
+	TestEqual(TEXT("Full at the grown capacity"), History.Num(), 5);
+	TestEqual(TEXT("Oldest after growing"), History[0].SequenceId, 10LL);
+	TestEqual(TEXT("Newest after growing"), History.Last().SequenceId, 14LL);
+
+	History.SetCapacity(0);
+	AddRange(History, 15, 16);
+	TestTrue(TEXT("Capacity 0 keeps nothing"), History.IsEmpty());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatMessageHistoryGetLastTest, "ChatSystem.History.GetLast", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatMessageHistoryGetLastTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatMessageHistoryTests;
+
+	FChatMessageHistory History;
+	History.SetCapacity(5);
+	AddRange(History, 1, 8);
+
+	TArray<FChatMessage> Messages;
+	History.GetLast(3, Messages);
+	if (TestEqual(TEXT("GetLast(3) returns 3"), Messages.Num(), 3))
+	{
+		TestEqual(TEXT("GetLast(3) starts at the oldest of the three"), Messages[0].SequenceId, 6LL);
+		TestEqual(TEXT("GetLast(3) ends at the newest"), Messages[2].SequenceId, 8LL);
+	}
+
+	History.GetLast(0, Messages);
+	if (TestEqual(TEXT("GetLast(0) returns everything"), Messages.Num(), 5))
+	{
+		TestEqual(TEXT("GetLast(0) is oldest first"), Messages[0].SequenceId, 4LL);
+	}
+
+	History.GetLast(100, Messages);
+	TestEqual(TEXT("GetLast beyond Num is clamped"), Messages.Num(), 5);
+
+	History.Empty();
+	History.GetLast(3, Messages);
+	TestEqual(TEXT("GetLast on an empty history"), Messages.Num(), 0);
+	TestEqual(TEXT("Empty keeps the capacity"), History.GetCapacity(), 5);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatMessageHistoryFindBySequenceTest, "ChatSystem.History.FindBySequence", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatMessageHistoryFindBySequenceTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatMessageHistoryTests;
+
+	FChatMessageHistory History;
+	TestNull(TEXT("Nothing to find in an empty history"), History.FindBySequence(1));
+
+	History.SetCapacity(4);
+	AddRange(History, 1, 10);
+
+	for (int64 Sequence = 7; Sequence <= 10; ++Sequence)
+	{
+		const FChatMessage* Message = History.FindBySequence(Sequence);
+		if (TestNotNull(FString::Printf(TEXT("Retained message %lld is found"), Sequence), Message))
+		{
+			TestEqual(TEXT("Found the right message"), Message->SequenceId, Sequence);
+		}
+	}
+
+	TestNull(TEXT("Evicted message is not found"), History.FindBySequence(6));
+	TestNull(TEXT("Future message is not found"), History.FindBySequence(11));
+	TestNull(TEXT("Unrouted id is not found"), History.FindBySequence(0));
+	TestEqual(TEXT("First sequence tracks eviction"), History.GetFirstSequence(), 7LL);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,242 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ChatTestPackageMap.h"
+#include "Tests/ChatTestWorld.h"
+#include "ChatComponent.h"
+#include "Data/ChatMessage.h"
+#include "Engine/NetSerialization.h"
+#include "GameFramework/PlayerState.h"
+#include "UObject/StrongObjectPtr.h"
+
+namespace ChatMessageNetSerializeTests
+{
+	/** Write a message with NetSerialize and read it back; returns the number of bits written */
+	int64 RoundTrip(FAutomationTestBase& Test, UPackageMap* Map, const FChatMessage& Source, FChatMessage& OutResult)
+	{
+		FChatMessage Copy = Source;
+		FNetBitWriter Writer(Map, 0);
+		bool bWriteSuccess = false;
+		Copy.NetSerialize(Writer, Map, bWriteSuccess);
+		Test.TestTrue(TEXT("Write succeeded"), bWriteSuccess && !Writer.IsError());
+
+		FNetBitReader Reader(Map, Writer.GetData(), Writer.GetNumBits());
+		bool bReadSuccess = false;
+		OutResult.NetSerialize(Reader, Map, bReadSuccess);
+		Test.TestTrue(TEXT("Read succeeded"), bReadSuccess && !Reader.IsError());
+		Test.TestEqual(TEXT("Reader consumed exactly what was written"), Reader.GetPosBits(), Writer.GetNumBits());
+
+		return Writer.GetNumBits();
+	}
+
+	/** Bits the same message takes with plain per-field serialization, the way it replicated before NetSerialize */
+	int64 PlainBits(UPackageMap* Map, const FChatMessage& Source)
+	{
+		FChatMessage Copy = Source;
+		FNetBitWriter Writer(Map, 0);
+
+		UObject* SenderObject = Copy.Sender;
+		UObject* WhisperTargetObject = Copy.WhisperTarget;
+		Map->SerializeObject(Writer, APlayerState::StaticClass(), SenderObject);
+		Map->SerializeObject(Writer, APlayerState::StaticClass(), WhisperTargetObject);
+		uint8 ChannelValue = static_cast<uint8>(Copy.Channel);
+		int64 Ticks = Copy.Timestamp.GetTicks();
+		Writer << Copy.SenderName << Copy.Content << ChannelValue << Ticks << Copy.MessageColor << Copy.CustomChannelId << Copy.SequenceId;
+
+		return Writer.GetNumBits();
+	}
+
+	bool IsNearlySameTime(const FDateTime& A, const FDateTime& B)
+	{
+		// Ages are sent in whole milliseconds and rebased onto the receiver's clock
+		return FMath::Abs((A - B).GetTotalMilliseconds()) < 100.0;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatMessageNetSerializeRoundTripTest, "ChatSystem.NetSerialize.RoundTrip", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatMessageNetSerializeRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatMessageNetSerializeTests;
+
+	ChatTests::FChatTestWorld TestWorld;
+	APlayerState* SenderState = Cast<APlayerState>(TestWorld.SpawnPlayer()->GetOwner());
+	APlayerState* TargetState = Cast<APlayerState>(TestWorld.SpawnPlayer()->GetOwner());
+	SenderState->SetPlayerName(TEXT("Sender"));
+
+	TStrongObjectPtr<UChatTestPackageMap> Map(NewObject<UChatTestPackageMap>());
+
+	// Every field set, with an explicit color that has to be quantized
+	{
+		FChatMessage Source(SenderState, TEXT("Hello \u00E9\u4E16\u754C"), EChatChannel::Whisper);
+		Source.SenderName = TEXT("Renamed Sender");
+		Source.WhisperTarget = TargetState;
+		Source.MessageColor = FLinearColor(0.2f, 0.4f, 0.6f, 1.0f);
+		Source.SequenceId = 123456789012LL;
+		Source.Timestamp = FDateTime::Now() - FTimespan::FromSeconds(5.0);
+
+		FChatMessage Result;
+		const int64 Bits = RoundTrip(*this, Map.Get(), Source, Result);
+		TestTrue(TEXT("Sender"), Result.Sender == SenderState);
+		TestTrue(TEXT("WhisperTarget"), Result.WhisperTarget == TargetState);
+		TestEqual(TEXT("SenderName"), Result.SenderName, Source.SenderName);
+		TestEqual(TEXT("Content"), Result.Content, Source.Content);
+		TestEqual(TEXT("Channel"), static_cast<uint8>(Result.Channel), static_cast<uint8>(Source.Channel));
+		TestEqual(TEXT("SequenceId"), Result.SequenceId, Source.SequenceId);
+		TestEqual(TEXT("CustomChannelId"), Result.CustomChannelId, static_cast<int32>(INDEX_NONE));
+		TestTrue(TEXT("Timestamp"), IsNearlySameTime(Result.Timestamp, Source.Timestamp));
+		TestEqual(TEXT("Color is quantized to RGBA8"), Result.MessageColor, Source.MessageColor.QuantizeRound().ReinterpretAsLinear());
+
+		const int64 Plain = PlainBits(Map.Get(), Source);
+		AddInfo(FString::Printf(TEXT("Player message: %lld bits, %lld with plain field serialization"), Bits, Plain));
+		TestTrue(TEXT("Smaller than plain field serialization"), Bits < Plain);
+	}
+
+	// System message: the default name and color are left off the wire and restored on receipt
+	{
+		FChatMessage Source(nullptr, TEXT("Server restarting"), EChatChannel::System);
+		Source.MessageColor = FChatMessage::GetDefaultChannelColor(EChatChannel::System);
+		Source.SequenceId = 2;
+
+		FChatMessage Result;
+		Result.SenderName = TEXT("Stale");
+		const int64 Bits = RoundTrip(*this, Map.Get(), Source, Result);
+		TestNull(TEXT("No sender"), Result.Sender.Get());
+		TestNull(TEXT("No whisper target"), Result.WhisperTarget.Get());
+		TestEqual(TEXT("System sender name restored"), Result.SenderName, FString(FChatMessage::SystemSenderName));
+		TestEqual(TEXT("Channel default color restored"), Result.MessageColor, Source.MessageColor);
+		TestEqual(TEXT("Content"), Result.Content, Source.Content);
+
+		const int64 Plain = PlainBits(Map.Get(), Source);
+		AddInfo(FString::Printf(TEXT("System message: %lld bits, %lld with plain field serialization"), Bits, Plain));
+		TestTrue(TEXT("Smaller than plain field serialization"), Bits < Plain);
+	}
+
+	// Custom channel id and the white default color
+	{
+		FChatMessage Source(SenderState, TEXT("Raid at 8"), EChatChannel::Custom);
+		Source.CustomChannelId = 7;
+		Source.MessageColor = FLinearColor::White;
+		Source.SequenceId = 3;
+
+		FChatMessage Result;
+		RoundTrip(*this, Map.Get(), Source, Result);
+		TestEqual(TEXT("CustomChannelId"), Result.CustomChannelId, 7);
+		TestEqual(TEXT("White restored"), Result.MessageColor, FLinearColor::White);
+		TestEqual(TEXT("Sender name"), Result.SenderName, FString(TEXT("Sender")));
+	}
+
+	return true;
+}
+
+/**
+ * Server cost of one team message sent to every member
+ * Legacy: a client RPC per member, so the message is serialized once per connection, and the name is left off
+ * for connections that already know the sender. Iris: the team relay's multicast is quantized once and the same
+ * bits are written to every connection, always with the name.
+ * The Iris serializer needs a running replication system to quantize object references, so the shared payload is
+ * written with NetSerialize and bForceSenderName, the field encoding the Iris serializer uses
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatMessageNetSerializeLegacyVsIrisBenchmark, "ChatSystem.NetSerialize.LegacyVsIrisBenchmark", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FChatMessageNetSerializeLegacyVsIrisBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumMessages = 2000;
+	constexpr int32 NumRecipients = 16;
+
+	ChatTests::FChatTestWorld TestWorld;
+	APlayerState* SenderState = Cast<APlayerState>(TestWorld.SpawnPlayer()->GetOwner());
+	SenderState->SetPlayerName(TEXT("Sender"));
+
+	TStrongObjectPtr<UChatTestPackageMap> Map(NewObject<UChatTestPackageMap>());
+
+	TArray<FChatMessage> Messages;
+	for (int32 i = 0; i < NumMessages; ++i)
+	{
+		FChatMessage& Message = Messages.Emplace_GetRef(SenderState, FString::Printf(TEXT("Push mid, they are rotating to B (%d)"), i), EChatChannel::Team);
+		Message.SequenceId = i + 1;
+	}
+
+	// The only difference between a known and an unknown sender is the name string
+	FNetBitWriter NameWriter(Map.Get(), 0);
+	FString SenderName = SenderState->GetPlayerName();
+	NameWriter << SenderName;
+
+	// Legacy: every recipient's RPC serializes the message again
+	int64 LegacyBits = 0;
+	double StartTime = FPlatformTime::Seconds();
+	for (FChatMessage& Message : Messages)
+	{
+		for (int32 Recipient = 0; Recipient < NumRecipients; ++Recipient)
+		{
+			FNetBitWriter Writer(Map.Get(), 0);
+			bool bSuccess = false;
+			Message.NetSerialize(Writer, Map.Get(), bSuccess);
+			LegacyBits += Writer.GetNumBits();
+		}
+	}
+	const double LegacyMicros = (FPlatformTime::Seconds() - StartTime) * 1000000.0 / NumMessages;
+
+	// Iris: serialized once, the bits copied into each connection's packet
+	int64 SharedBits = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (FChatMessage& Message : Messages)
+	{
+		Message.bForceSenderName = true;
+		FNetBitWriter SharedWriter(Map.Get(), 0);
+		bool bSuccess = false;
+		Message.NetSerialize(SharedWriter, Map.Get(), bSuccess);
+
+		for (int32 Recipient = 0; Recipient < NumRecipients; ++Recipient)
+		{
+			FNetBitWriter Writer(Map.Get(), 0);
+			Writer.SerializeBits(SharedWriter.GetData(), SharedWriter.GetNumBits());
+			SharedBits += Writer.GetNumBits();
+		}
+	}
+	const double SharedMicros = (FPlatformTime::Seconds() - StartTime) * 1000000.0 / NumMessages;
+
+	const double LegacyUnknownBits = static_cast<double>(LegacyBits) / (NumMessages * NumRecipients);
+	const double LegacyKnownBits = LegacyUnknownBits - NameWriter.GetNumBits();
+	const double IrisBits = static_cast<double>(SharedBits) / (NumMessages * NumRecipients);
+
+	AddInfo(FString::Printf(TEXT("%d messages to %d recipients, server CPU per message: legacy %.2f us, Iris %.2f us"), NumMessages, NumRecipients, LegacyMicros, SharedMicros));
+	AddInfo(FString::Printf(TEXT("Bits per message per recipient: legacy %.0f (%.0f before the sender is known), Iris %.0f"), LegacyKnownBits, LegacyUnknownBits, IrisBits));
+	TestEqual(TEXT("Shared payload matches a legacy payload that carries the name"), IrisBits, LegacyUnknownBits);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatMessageNetSerializeInvalidChannelTest, "ChatSystem.NetSerialize.InvalidChannel", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatMessageNetSerializeInvalidChannelTest::RunTest(const FString& Parameters)
+{
+	TStrongObjectPtr<UChatTestPackageMap> Map(NewObject<UChatTestPackageMap>());
+
+	// Every 3-bit channel value past the last EChatChannel
+	for (uint8 ChannelValue = NumChatChannels; ChannelValue < 8; ++ChannelValue)
+	{
+		FNetBitWriter Writer(Map.Get(), 0);
+		uint8 Flags = 0;
+		uint8 ColorMode = 0;
+		uint64 Sequence = 1;
+		Writer.SerializeBits(&ChannelValue, 3);
+		Writer.SerializeBits(&Flags, 4);
+		Writer.SerializeBits(&ColorMode, 2);
+		Writer.SerializeIntPacked64(Sequence);
+
+		FNetBitReader Reader(Map.Get(), Writer.GetData(), Writer.GetNumBits());
+		FChatMessage Result;
+		bool bSuccess = true;
+		Result.NetSerialize(Reader, Map.Get(), bSuccess);
+		TestFalse(FString::Printf(TEXT("Channel %d is rejected"), ChannelValue), bSuccess);
+		TestTrue(FString::Printf(TEXT("Channel %d sets the archive error"), ChannelValue), Reader.IsError());
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
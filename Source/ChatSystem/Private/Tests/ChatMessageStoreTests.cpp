@@ -0,0 +1,167 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Data/ChatMessageStore.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ChatMessageStoreTests
+{
+	/** Rows a list built from ConsumeChanges shows for one channel: [First, End) */
+	struct FListView
+	{
+		int64 First = 0;
+		int64 End = 0;
+	};
+
+	/**
+	 * Check the store's retained range for every channel, then apply its pending changes to the list views
+	 * and check that they end up showing exactly what the store retains
+	 * @return Number of problems found
+	 */
+	int32 CheckAndConsume(FAutomationTestBase& Test, FChatMessageStore& Store, FListView (&Views)[NumChatChannels], const int64 (&NumAdded)[NumChatChannels])
+	{
+		int32 NumErrors = 0;
+		auto Check = [&Test, &NumErrors](bool bCondition, const FString& What)
+		{
+			if (!bCondition)
+			{
+				Test.AddError(What);
+				++NumErrors;
+			}
+		};
+
+		for (int32 ChannelIndex = 0; ChannelIndex < NumChatChannels; ++ChannelIndex)
+		{
+			const EChatChannel Channel = static_cast<EChatChannel>(ChannelIndex);
+			const int64 First = Store.GetFirstIndex(Channel);
+			const int64 End = Store.GetEndIndex(Channel);
+
+			Check(End == NumAdded[ChannelIndex], FString::Printf(TEXT("Channel %d: end index %lld, expected %lld"), ChannelIndex, End, NumAdded[ChannelIndex]));
+			Check(End - First <= Store.GetCapacity(), FString::Printf(TEXT("Channel %d: %lld retained over capacity %d"), ChannelIndex, End - First, Store.GetCapacity()));
+			Check(First >= 0 && First <= End, FString::Printf(TEXT("Channel %d: bad range [%lld, %lld)"), ChannelIndex, First, End));
+			Check(Store.Find(Channel, First - 1) == nullptr, FString::Printf(TEXT("Channel %d: evicted index still found"), ChannelIndex));
+			Check(Store.Find(Channel, End) == nullptr, FString::Printf(TEXT("Channel %d: index past the end found"), ChannelIndex));
+			if (End > First)
+			{
+				const FChatMessage* Oldest = Store.Find(Channel, First);
+				const FChatMessage* Newest = Store.Find(Channel, End - 1);
+				Check(Oldest && Oldest->SequenceId == First, FString::Printf(TEXT("Channel %d: wrong oldest message"), ChannelIndex));
+				Check(Newest && Newest->SequenceId == End - 1, FString::Printf(TEXT("Channel %d: wrong newest message"), ChannelIndex));
+			}
+		}
+
+		TArray<FChatStoreChange> Changes;
+		Store.ConsumeChanges(Changes);
+
+		bool bChanged[NumChatChannels] = {};
+		for (const FChatStoreChange& Change : Changes)
+		{
+			const int32 ChannelIndex = static_cast<int32>(Change.Channel);
+			const int64 First = Store.GetFirstIndex(Change.Channel);
+			const int64 End = Store.GetEndIndex(Change.Channel);
+			FListView& View = Views[ChannelIndex];
+			bChanged[ChannelIndex] = true;
+
+			Check(Change.NumEvicted >= 0 && Change.NumAppended >= 0, FString::Printf(TEXT("Channel %d: negative change"), ChannelIndex));
+			Check(Change.FirstEvicted == View.First, FString::Printf(TEXT("Channel %d: eviction starts at %lld, list starts at %lld"), ChannelIndex, Change.FirstEvicted, View.First));
+			Check(Change.FirstEvicted + Change.NumEvicted <= View.End, FString::Printf(TEXT("Channel %d: evicts rows the list never had"), ChannelIndex));
+			Check(Change.FirstAppended == FMath::Max(View.End, First), FString::Printf(TEXT("Channel %d: append starts at %lld"), ChannelIndex, Change.FirstAppended));
+			Check(Change.FirstAppended + Change.NumAppended == End, FString::Printf(TEXT("Channel %d: append does not reach the end"), ChannelIndex));
+
+			// Rows the list keeps run straight on from the evicted ones
+			const int64 Kept = View.End - (Change.FirstEvicted + Change.NumEvicted);
+			Check(Kept <= 0 || Change.FirstEvicted + Change.NumEvicted == First, FString::Printf(TEXT("Channel %d: kept rows are not the retained front"), ChannelIndex));
+
+			View.First = First;
+			View.End = End;
+		}
+
+		for (int32 ChannelIndex = 0; ChannelIndex < NumChatChannels; ++ChannelIndex)
+		{
+			const EChatChannel Channel = static_cast<EChatChannel>(ChannelIndex);
+			if (!bChanged[ChannelIndex])
+			{
+				Check(Views[ChannelIndex].First == Store.GetFirstIndex(Channel) && Views[ChannelIndex].End == Store.GetEndIndex(Channel),
+					FString::Printf(TEXT("Channel %d changed without a notification"), ChannelIndex));
+			}
+		}
+
+		return NumErrors;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatMessageStoreSoakTest, "ChatSystem.MessageStore.Soak", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatMessageStoreSoakTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatMessageStoreTests;
+
+	constexpr int32 NumMessages = 100000;
+	FRandomStream Random(7);
+
+	FChatMessageStore Store;
+	Store.SetCapacity(100);
+
+	FListView Views[NumChatChannels];
+	int64 NumAdded[NumChatChannels] = {};
+	int32 NumErrors = 0;
+
+	int32 NextConsume = Random.RandRange(1, 300);
+	for (int32 i = 0; i < NumMessages && NumErrors == 0; ++i)
+	{
+		// Global and proximity are far busier than the rest, so they wrap constantly
+		const int32 Roll = Random.RandRange(0, 9);
+		const EChatChannel Channel = Roll < 5 ? EChatChannel::Global : Roll < 8 ? EChatChannel::Proximity : static_cast<EChatChannel>(Random.RandRange(0, NumChatChannels - 1));
+		const int32 ChannelIndex = static_cast<int32>(Channel);
+
+		FChatMessage Message;
+		Message.Channel = Channel;
+		Message.SequenceId = NumAdded[ChannelIndex]++;
+		Store.Add(Message);
+
+		if (--NextConsume == 0)
+		{
+			NumErrors += CheckAndConsume(*this, Store, Views, NumAdded);
+			NextConsume = Random.RandRange(1, 300);
+		}
+
+		// Resize and clear now and then, as the UI or a reconnect would
+		if (i % 25000 == 12500)
+		{
+			Store.SetCapacity(Random.RandRange(10, 200));
+			NumErrors += CheckAndConsume(*this, Store, Views, NumAdded);
+		}
+		if (i == NumMessages / 2)
+		{
+			Store.Empty();
+			NumErrors += CheckAndConsume(*this, Store, Views, NumAdded);
+		}
+	}
+	NumErrors += CheckAndConsume(*this, Store, Views, NumAdded);
+
+	// Busy channels end full, at their last capacity
+	TestEqual(TEXT("Busy channel is at capacity"), Store.GetEndIndex(EChatChannel::Global) - Store.GetFirstIndex(EChatChannel::Global), static_cast<int64>(Store.GetCapacity()));
+
+	// Ranges are clipped to what is retained
+	const int64 First = Store.GetFirstIndex(EChatChannel::Global);
+	const int64 End = Store.GetEndIndex(EChatChannel::Global);
+	TArray<FChatMessage> Range;
+	Store.GetRange(EChatChannel::Global, First - 50, 60, Range);
+	if (TestEqual(TEXT("Range starting before the retained front"), Range.Num(), 10))
+	{
+		TestEqual(TEXT("Clipped range starts at the front"), Range[0].SequenceId, First);
+	}
+	Store.GetRange(EChatChannel::Global, End - 5, 100, Range);
+	TestEqual(TEXT("Range running past the end"), Range.Num(), 5);
+	Store.GetRange(EChatChannel::Global, End, 10, Range);
+	TestEqual(TEXT("Range after the end"), Range.Num(), 0);
+	Store.GetRange(EChatChannel::Global, First, -1, Range);
+	TestEqual(TEXT("Negative count"), Range.Num(), 0);
+
+	TestEqual(TEXT("No errors during the soak"), NumErrors, 0);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
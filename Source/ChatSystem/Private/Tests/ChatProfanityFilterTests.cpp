@@ -0,0 +1,149 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Filters/ChatProfanityFilter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ChatProfanityFilterTests
+{
+	/** Mask a copy of Text and return it */
+	FString Masked(const FChatProfanityFilter& Filter, const FString& Text)
+	{
+		FString Result = Text;
+		Filter.Mask(Result);
+		return Result;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatProfanityFilterWholeWordTest, "ChatSystem.ProfanityFilter.WholeWord", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatProfanityFilterWholeWordTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatProfanityFilterTests;
+
+	const TSharedRef<const FChatProfanityFilter> Filter = FChatProfanityFilter::Build({ TEXT("ass"), TEXT("bad"), TEXT("badword") });
+	TestEqual(TEXT("Every pattern is added"), Filter->GetNumPatterns(), 3);
+
+	TestTrue(TEXT("Word on its own"), Filter->ContainsMatch(TEXT("ass")));
+	TestTrue(TEXT("Word inside a sentence"), Filter->ContainsMatch(TEXT("what a bad idea")));
+	TestTrue(TEXT("Matching ignores case"), Filter->ContainsMatch(TEXT("BaD")));
+	TestTrue(TEXT("Trailing punctuation ends the word"), Filter->ContainsMatch(TEXT("you ass!")));
+	TestTrue(TEXT("Longer pattern sharing a prefix"), Filter->ContainsMatch(TEXT("badword")));
+
+	TestFalse(TEXT("Inside a longer word"), Filter->ContainsMatch(TEXT("class")));
+	TestFalse(TEXT("At the start of a longer word"), Filter->ContainsMatch(TEXT("assassin")));
+	TestFalse(TEXT("Prefix of a pattern"), Filter->ContainsMatch(TEXT("ba")));
+	TestFalse(TEXT("Between two patterns"), Filter->ContainsMatch(TEXT("badwor")));
+	TestFalse(TEXT("Clean text"), Filter->ContainsMatch(TEXT("good game everyone")));
+	TestFalse(TEXT("Empty text"), Filter->ContainsMatch(FString()));
+
+	TestEqual(TEXT("Only the matched words are masked"), Masked(*Filter, TEXT("a bad class, ass!")), FString(TEXT("a *** class, ***!")));
+
+	FString Clean = TEXT("nothing here");
+	TestFalse(TEXT("Mask reports when nothing matched"), Filter->Mask(Clean));
+	TestEqual(TEXT("Clean text is untouched"), Clean, FString(TEXT("nothing here")));
+
+	const TSharedRef<const FChatProfanityFilter> Empty = FChatProfanityFilter::Build({ TEXT(""), TEXT("*"), TEXT("**") });
+	TestEqual(TEXT("Empty patterns are skipped"), Empty->GetNumPatterns(), 0);
+	TestFalse(TEXT("An empty filter matches nothing"), Empty->ContainsMatch(TEXT("anything at all")));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatProfanityFilterPartialTest, "ChatSystem.ProfanityFilter.Partial", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatProfanityFilterPartialTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatProfanityFilterTests;
+
+	// "*word*" anywhere, "word*" at the start of a word, "*word" at the end of one
+	const TSharedRef<const FChatProfanityFilter> Filter = FChatProfanityFilter::Build({ TEXT("*dang*"), TEXT("heck*"), TEXT("*crud") });
+
+	TestTrue(TEXT("Anywhere pattern on its own"), Filter->ContainsMatch(TEXT("dang")));
+	TestTrue(TEXT("Anywhere pattern inside a word"), Filter->ContainsMatch(TEXT("oldangel")));
+	TestTrue(TEXT("Prefix pattern starting a word"), Filter->ContainsMatch(TEXT("heckin")));
+	TestTrue(TEXT("Prefix pattern on its own"), Filter->ContainsMatch(TEXT("heck")));
+	TestTrue(TEXT("Suffix pattern ending a word"), Filter->ContainsMatch(TEXT("supercrud")));
+
+	TestFalse(TEXT("Prefix pattern in the middle of a word"), Filter->ContainsMatch(TEXT("checking")));
+	TestFalse(TEXT("Suffix pattern starting a longer word"), Filter->ContainsMatch(TEXT("cruddy")));
+	TestFalse(TEXT("A match never spans two words"), Filter->ContainsMatch(TEXT("da ng")));
+
+	TestEqual(TEXT("Partial matches mask only the pattern"), Masked(*Filter, TEXT("oldangel heckin supercrud")), FString(TEXT("ol****el ****in super****")));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatProfanityFilterSubstitutionTest, "ChatSystem.ProfanityFilter.Substitution", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatProfanityFilterSubstitutionTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatProfanityFilterTests;
+
+	const TSharedRef<const FChatProfanityFilter> Filter = FChatProfanityFilter::Build({ TEXT("bad"), TEXT("ass"), TEXT("shit"), TEXT("l33t") });
+
+	TestTrue(TEXT("Digit substitution"), Filter->ContainsMatch(TEXT("b4d")));
+	TestTrue(TEXT("Symbol substitution inside a word"), Filter->ContainsMatch(TEXT("b@d")));
+	TestTrue(TEXT("Several substitutions"), Filter->ContainsMatch(TEXT("a55")));
+	TestTrue(TEXT("Symbol starting a word"), Filter->ContainsMatch(TEXT("$hit")));
+	TestTrue(TEXT("Symbol in the middle of a word"), Filter->ContainsMatch(TEXT("sh!t")));
+	TestTrue(TEXT("Substitutions in the pattern are folded too"), Filter->ContainsMatch(TEXT("leet")));
+	TestTrue(TEXT("Substituted pattern still matches as written"), Filter->ContainsMatch(TEXT("L33T")));
+
+	// Folding is only applied to words with a letter in them
+	TestFalse(TEXT("Plain numbers are not folded"), Filter->ContainsMatch(TEXT("455")));
+	TestFalse(TEXT("Numbers inside a sentence are not folded"), Filter->ContainsMatch(TEXT("scored 455 points")));
+
+	// A symbol only counts as part of a word when a letter or digit follows it
+	TestTrue(TEXT("A trailing symbol does not hide the word"), Filter->ContainsMatch(TEXT("bad!")));
+	TestEqual(TEXT("Trailing symbol is left unmasked"), Masked(*Filter, TEXT("bad!")), FString(TEXT("***!")));
+	TestEqual(TEXT("Substituted characters are masked"), Masked(*Filter, TEXT("so b4d, $hit")), FString(TEXT("so ***, ****")));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatProfanityValidatorModesTest, "ChatSystem.ProfanityFilter.ValidatorModes", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatProfanityValidatorModesTest::RunTest(const FString& Parameters)
+{
+	const TSharedRef<const FChatProfanityFilter> Filter = FChatProfanityFilter::Build({ TEXT("bad") });
+
+	{
+		const FChatProfanityValidator Validator(Filter, EChatProfanityFilterMode::Reject);
+		FChatModerationContext Context;
+		Context.Message.Content = TEXT("a bad message");
+		TestTrue(TEXT("Reject mode rejects"), Validator.Validate(Context) == EChatRejectReason::ProfanityDetected);
+
+		Context.Message.Content = TEXT("a fine message");
+		TestTrue(TEXT("Reject mode lets clean text through"), Validator.Validate(Context) == EChatRejectReason::None);
+		TestFalse(TEXT("Profanity runs on the game thread"), Validator.RunsOffGameThread());
+	}
+
+	{
+		const FChatProfanityValidator Validator(Filter, EChatProfanityFilterMode::Mask);
+		FChatModerationContext Context;
+		Context.Message.Content = TEXT("a bad message");
+		TestTrue(TEXT("Mask mode delivers"), Validator.Validate(Context) == EChatRejectReason::None);
+		TestEqual(TEXT("Mask mode rewrites the content"), Context.Message.Content, FString(TEXT("a *** message")));
+		TestFalse(TEXT("Mask mode does not flag"), Context.bFlagged);
+	}
+
+	{
+		const FChatProfanityValidator Validator(Filter, EChatProfanityFilterMode::Flag);
+		FChatModerationContext Context;
+		Context.Message.Content = TEXT("a bad message");
+		TestTrue(TEXT("Flag mode delivers"), Validator.Validate(Context) == EChatRejectReason::None);
+		TestTrue(TEXT("Flag mode flags"), Context.bFlagged);
+		TestEqual(TEXT("Flag mode leaves the content alone"), Context.Message.Content, FString(TEXT("a bad message")));
+
+		Context.bFlagged = false;
+		Context.Message.Content = TEXT("a fine message");
+		Validator.Validate(Context);
+		TestFalse(TEXT("Clean text is not flagged"), Context.bFlagged);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,168 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ChatTestWorld.h"
+#include "ChatComponent.h"
+#include "ChatSubsystem.h"
+#include "GameFramework/PlayerState.h"
+#include "Math/RandomStream.h"
+
+namespace ChatRegistrationTests
+{
+	/** Check that every expected component is registered and found through its PlayerState, and nothing else is */
+	bool TestIndexMatches(FAutomationTestBase& Test, const UChatSubsystem& Subsystem, const TArray<UChatComponent*>& Expected)
+	{
+		bool bOk = Test.TestEqual(TEXT("Registered count"), Subsystem.GetRegisteredComponents().Num(), Expected.Num());
+
+		for (UChatComponent* Component : Expected)
+		{
+			APlayerState* PlayerState = Cast<APlayerState>(Component->GetOwner());
+			if (Subsystem.GetChatComponentForPlayer(PlayerState) != Component || !Subsystem.GetRegisteredComponents().Contains(Component))
+			{
+				Test.AddError(FString::Printf(TEXT("%s is not indexed under its PlayerState"), *Component->GetName()));
+				bOk = false;
+			}
+		}
+		return bOk;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatRegistrationStressTest, "ChatSystem.Registration.Stress", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatRegistrationStressTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatRegistrationTests;
+
+	ChatTests::FChatTestWorld TestWorld;
+	UChatSubsystem* Subsystem = TestWorld.GetSubsystem();
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	constexpr int32 NumPlayers = 2000;
+	FRandomStream Random(42);
+
+	TArray<UChatComponent*> Registered;
+	TArray<UChatComponent*> Unregistered;
+	TSet<int32> KeysHandedOut;
+
+	for (int32 i = 0; i < NumPlayers; ++i)
+	{
+		UChatComponent* Component = TestWorld.SpawnPlayer();
+		Subsystem->RegisterChatComponent(Component);
+		Registered.Add(Component);
+
+		const int32 PlayerKey = Subsystem->GetPlayerKey(Cast<APlayerState>(Component->GetOwner()));
+		TestNotEqual(TEXT("Registered player has a key"), PlayerKey, static_cast<int32>(INDEX_NONE));
+		TestFalse(TEXT("Keys are unique"), KeysHandedOut.Contains(PlayerKey));
+		KeysHandedOut.Add(PlayerKey);
+	}
+	TestIndexMatches(*this, *Subsystem, Registered);
+
+	// Several rounds of unregistering and re-registering in random order
+	for (int32 Round = 0; Round < 5; ++Round)
+	{
+		for (int32 i = Registered.Num() - 1; i >= 0; --i)
+		{
+			if (Random.FRand() < 0.5f)
+			{
+				Subsystem->UnregisterChatComponent(Registered[i]);
+				TestNull(TEXT("Unregistered player is not found"), Subsystem->GetChatComponentForPlayer(Cast<APlayerState>(Registered[i]->GetOwner())));
+				Unregistered.Add(Registered[i]);
+				Registered.RemoveAtSwap(i);
+			}
+		}
+		TestIndexMatches(*this, *Subsystem, Registered);
+
+		for (int32 i = Unregistered.Num() - 1; i >= 0; --i)
+		{
+			if (Random.FRand() < 0.5f)
+			{
+				UChatComponent* Component = Unregistered[i];
+				Subsystem->RegisterChatComponent(Component);
+				Registered.Add(Component);
+				Unregistered.RemoveAtSwap(i);
+
+				// Coming back is a new registration with a fresh key
+				const int32 PlayerKey = Subsystem->GetPlayerKey(Cast<APlayerState>(Component->GetOwner()));
+				TestFalse(TEXT("Keys are never reused"), KeysHandedOut.Contains(PlayerKey));
+				KeysHandedOut.Add(PlayerKey);
+			}
+		}
+		TestIndexMatches(*this, *Subsystem, Registered);
+	}
+
+	// Registering twice is a no-op
+	Subsystem->RegisterChatComponent(Registered[0]);
+	TestIndexMatches(*this, *Subsystem, Registered);
+
+	for (UChatComponent* Component : Registered)
+	{
+		Subsystem->UnregisterChatComponent(Component);
+	}
+	TestEqual(TEXT("Everything unregistered"), Subsystem->GetRegisteredComponents().Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatRegistrationKeyCollisionTest, "ChatSystem.Registration.KeyCollision", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatRegistrationKeyCollisionTest::RunTest(const FString& Parameters)
+{
+	ChatTests::FChatTestWorld TestWorld;
+	UChatSubsystem* Subsystem = TestWorld.GetSubsystem();
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	UChatComponent* First = TestWorld.SpawnPlayer();
+	APlayerState* PlayerState = Cast<APlayerState>(First->GetOwner());
+	Subsystem->RegisterChatComponent(First);
+	const int32 FirstKey = Subsystem->GetPlayerKey(PlayerState);
+
+	// A second live component on the same PlayerState never evicts the first
+	UChatComponent* Duplicate = NewObject<UChatComponent>(PlayerState);
+	Subsystem->RegisterChatComponent(Duplicate);
+	TestEqual(TEXT("Duplicate is tracked"), Subsystem->GetRegisteredComponents().Num(), 2);
+	TestTrue(TEXT("First component keeps the index"), Subsystem->GetChatComponentForPlayer(PlayerState) == First);
+	TestEqual(TEXT("Key is unchanged"), Subsystem->GetPlayerKey(PlayerState), FirstKey);
+
+	Subsystem->RegisterChatComponent(Duplicate);
+	TestEqual(TEXT("Registering the duplicate again is a no-op"), Subsystem->GetRegisteredComponents().Num(), 2);
+
+	Subsystem->UnregisterChatComponent(Duplicate);
+	TestTrue(TEXT("Removing the duplicate leaves the first indexed"), Subsystem->GetChatComponentForPlayer(PlayerState) == First);
+	TestEqual(TEXT("Only the first is left"), Subsystem->GetRegisteredComponents().Num(), 1);
+
+	// A component destroyed without unregistering is replaced by the next one for its PlayerState
+	First->MarkAsGarbage();
+	UChatComponent* Replacement = NewObject<UChatComponent>(PlayerState);
+	Subsystem->RegisterChatComponent(Replacement);
+	TestTrue(TEXT("Stale component is replaced"), Subsystem->GetChatComponentForPlayer(PlayerState) == Replacement);
+	TestEqual(TEXT("Stale component is dropped"), Subsystem->GetRegisteredComponents().Num(), 1);
+
+	// Players sharing a PlayerId (0 for bots and before it is assigned) still get their own keys
+	UChatComponent* BotA = TestWorld.SpawnPlayer();
+	UChatComponent* BotB = TestWorld.SpawnPlayer();
+	Cast<APlayerState>(BotA->GetOwner())->SetPlayerId(0);
+	Cast<APlayerState>(BotB->GetOwner())->SetPlayerId(0);
+	Subsystem->RegisterChatComponent(BotA);
+	Subsystem->RegisterChatComponent(BotB);
+	TestTrue(TEXT("Bot A is indexed"), Subsystem->GetChatComponentForPlayer(Cast<APlayerState>(BotA->GetOwner())) == BotA);
+	TestTrue(TEXT("Bot B is indexed"), Subsystem->GetChatComponentForPlayer(Cast<APlayerState>(BotB->GetOwner())) == BotB);
+	TestNotEqual(TEXT("Bots have different keys"), Subsystem->GetPlayerKey(Cast<APlayerState>(BotA->GetOwner())), Subsystem->GetPlayerKey(Cast<APlayerState>(BotB->GetOwner())));
+
+	// Unregistered players have no key
+	UChatComponent* Stranger = TestWorld.SpawnPlayer();
+	TestEqual(TEXT("Unregistered player has no key"), Subsystem->GetPlayerKey(Cast<APlayerState>(Stranger->GetOwner())), static_cast<int32>(INDEX_NONE));
+	TestNull(TEXT("Unregistered player has no component"), Subsystem->GetChatComponentForPlayer(Cast<APlayerState>(Stranger->GetOwner())));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,212 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ChatTestWorld.h"
+#include "ChatComponent.h"
+#include "ChatSubsystem.h"
+#include "GameFramework/PlayerState.h"
+
+namespace ChatReliableBacklogTests
+{
+	/** Unbatched reliable whispers, moderated inline and never rate limited */
+	void UseReliableSettings(UChatSubsystem& Subsystem, int32 MaxBatchSize, int32 MaxReliableBacklog)
+	{
+		FChatSettings Settings = Subsystem.GetChatSettings();
+		Settings.bAsyncModeration = false;
+		Settings.RateLimit.MessagesPerSecond = 100000.0f;
+		Settings.RateLimit.Burst = 100000;
+		Settings.bEnableMessageBatching = false;
+		Settings.MaxBatchSize = MaxBatchSize;
+		Settings.MaxBatchBytes = 1 << 20;
+		Settings.MaxReliableBacklog = MaxReliableBacklog;
+		Subsystem.SetChatSettings(Settings);
+	}
+
+	void Whisper(UChatSubsystem& Subsystem, UChatComponent* Sender, UChatComponent* Target, int32 Number)
+	{
+		FChatMessage Message;
+		Message.Sender = Cast<APlayerState>(Sender->GetOwner());
+		Message.WhisperTarget = Cast<APlayerState>(Target->GetOwner());
+		Message.Channel = EChatChannel::Whisper;
+		Message.Content = FString::FromInt(Number);
+		Subsystem.SubmitMessage(Message, false);
+	}
+
+	/** Contents of the messages a component received on a channel, oldest first */
+	TArray<FString> Received(const UChatComponent* Component, EChatChannel Channel)
+	{
+		int64 First = 0;
+		int64 End = 0;
+		Component->GetStoredMessageBounds(Channel, First, End);
+
+		TArray<FString> Contents;
+		for (const FChatMessage& Message : Component->GetStoredMessages(Channel, First, static_cast<int32>(End - First)))
+		{
+			Contents.Add(Message.Content);
+		}
+		return Contents;
+	}
+
+	/** "First" to "Last" inclusive, as whisper contents */
+	TArray<FString> Numbers(int32 First, int32 Last)
+	{
+		TArray<FString> Contents;
+		for (int32 i = First; i <= Last; ++i)
+		{
+			Contents.Add(FString::FromInt(i));
+		}
+		return Contents;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatReliableBacklogHoldBackTest, "ChatSystem.ReliableBacklog.HoldBack", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatReliableBacklogHoldBackTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatReliableBacklogTests;
+
+	ChatTests::FChatTestWorld TestWorld;
+	UChatSubsystem* Subsystem = TestWorld.GetSubsystem();
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+	UseReliableSettings(*Subsystem, 32, 100);
+
+	UChatComponent* A = TestWorld.SpawnPlayingPlayer();
+	UChatComponent* B = TestWorld.SpawnPlayingPlayer();
+	const FChatBatchingStats Before = Subsystem->GetBatchingStats();
+
+	bool bSaturated = true;
+	Subsystem->ReliableBufferSaturatedOverride = [&bSaturated](const UChatComponent*) { return bSaturated; };
+
+	// Held back while the reliable buffer is near full; whispers reach both ends
+	for (int32 i = 0; i < 3; ++i)
+	{
+		Whisper(*Subsystem, A, B, i);
+	}
+	TestEqual(TEXT("Nothing sent while saturated"), Received(B, EChatChannel::Whisper).Num(), 0);
+	TestEqual(TEXT("Every delivery deferred"), Subsystem->GetBatchingStats().ReliableMessagesDeferred - Before.ReliableMessagesDeferred, 6LL);
+
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("Flushing while saturated sends nothing"), Received(B, EChatChannel::Whisper).Num(), 0);
+
+	// Once the buffer drains, new messages still queue behind the backlog so order is kept
+	bSaturated = false;
+	Whisper(*Subsystem, A, B, 3);
+	TestEqual(TEXT("Queued behind the backlog"), Received(B, EChatChannel::Whisper).Num(), 0);
+	TestEqual(TEXT("Counted as deferred"), Subsystem->GetBatchingStats().ReliableMessagesDeferred - Before.ReliableMessagesDeferred, 8LL);
+
+	const int64 RPCsBefore = Subsystem->GetBatchingStats().RPCsSent;
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("Backlog delivered in order"), Received(B, EChatChannel::Whisper), Numbers(0, 3));
+	TestEqual(TEXT("Sender's copies too"), Received(A, EChatChannel::Whisper), Numbers(0, 3));
+	TestEqual(TEXT("One RPC per recipient"), Subsystem->GetBatchingStats().RPCsSent - RPCsBefore, 2LL);
+	TestEqual(TEXT("Nothing skipped"), Subsystem->GetBatchingStats().ReliableMessagesSkipped - Before.ReliableMessagesSkipped, 0LL);
+
+	// With the backlog gone, messages go straight out again
+	Whisper(*Subsystem, A, B, 4);
+	TestEqual(TEXT("Sent at once"), Received(B, EChatChannel::Whisper), Numbers(0, 4));
+	TestEqual(TEXT("No longer deferred"), Subsystem->GetBatchingStats().ReliableMessagesDeferred - Before.ReliableMessagesDeferred, 8LL);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatReliableBacklogSkipTest, "ChatSystem.ReliableBacklog.Skip", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatReliableBacklogSkipTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatReliableBacklogTests;
+
+	ChatTests::FChatTestWorld TestWorld;
+	UChatSubsystem* Subsystem = TestWorld.GetSubsystem();
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+	UseReliableSettings(*Subsystem, 32, 5);
+
+	UChatComponent* A = TestWorld.SpawnPlayingPlayer();
+	UChatComponent* B = TestWorld.SpawnPlayingPlayer();
+	const FChatBatchingStats Before = Subsystem->GetBatchingStats();
+
+	bool bSaturated = true;
+	Subsystem->ReliableBufferSaturatedOverride = [&bSaturated](const UChatComponent*) { return bSaturated; };
+
+	for (int32 i = 0; i < 12; ++i)
+	{
+		Whisper(*Subsystem, A, B, i);
+	}
+
+	// A flush while saturated trims each backlog to the newest MaxReliableBacklog messages
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("Oldest dropped for each recipient"), Subsystem->GetBatchingStats().ReliableMessagesSkipped - Before.ReliableMessagesSkipped, 14LL);
+	TestEqual(TEXT("Nothing sent while saturated"), Received(B, EChatChannel::Whisper).Num(), 0);
+
+	bSaturated = false;
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("Only the newest are delivered"), Received(B, EChatChannel::Whisper), Numbers(7, 11));
+	TestEqual(TEXT("Skipped messages are summarized"), Received(B, EChatChannel::System), TArray<FString>({ TEXT("7 messages skipped") }));
+	TestEqual(TEXT("Summary and kept messages go out together"), Subsystem->GetBatchingStats().RPCsSent - Before.RPCsSent, 2LL);
+
+	// The summary is reported once
+	Whisper(*Subsystem, A, B, 12);
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("No second summary"), Received(B, EChatChannel::System).Num(), 1);
+	TestEqual(TEXT("Later messages arrive normally"), Received(B, EChatChannel::Whisper), Numbers(7, 12));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatReliableBacklogChunkedTest, "ChatSystem.ReliableBacklog.Chunked", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatReliableBacklogChunkedTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatReliableBacklogTests;
+
+	ChatTests::FChatTestWorld TestWorld;
+	UChatSubsystem* Subsystem = TestWorld.GetSubsystem();
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+	UseReliableSettings(*Subsystem, 4, 100);
+
+	UChatComponent* A = TestWorld.SpawnPlayingPlayer();
+	UChatComponent* B = TestWorld.SpawnPlayingPlayer();
+
+	bool bSaturated = true;
+	int32 SaturateAfter = MAX_int32;
+	Subsystem->ReliableBufferSaturatedOverride = [&bSaturated, &SaturateAfter, B](const UChatComponent* Recipient)
+	{
+		return bSaturated || (Recipient == B && Received(B, EChatChannel::Whisper).Num() >= SaturateAfter);
+	};
+
+	for (int32 i = 0; i < 10; ++i)
+	{
+		Whisper(*Subsystem, A, B, i);
+	}
+
+	// B's buffer fills again after two chunks; A takes the whole backlog
+	bSaturated = false;
+	SaturateAfter = 8;
+	const int64 RPCsBefore = Subsystem->GetBatchingStats().RPCsSent;
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("Whole chunks sent until saturated"), Received(B, EChatChannel::Whisper), Numbers(0, 7));
+	TestEqual(TEXT("Unsaturated recipient gets everything"), Received(A, EChatChannel::Whisper), Numbers(0, 9));
+	TestEqual(TEXT("One RPC per MaxBatchSize chunk"), Subsystem->GetBatchingStats().RPCsSent - RPCsBefore, 5LL);
+
+	// The rest follows once B drains
+	SaturateAfter = MAX_int32;
+	Subsystem->FlushPendingBatches();
+	TestEqual(TEXT("Remainder delivered in order"), Received(B, EChatChannel::Whisper), Numbers(0, 9));
+	TestEqual(TEXT("Remainder is one chunk"), Subsystem->GetBatchingStats().RPCsSent - RPCsBefore, 6LL);
+	TestEqual(TEXT("Nothing skipped"), Subsystem->GetBatchingStats().ReliableMessagesSkipped, 0LL);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
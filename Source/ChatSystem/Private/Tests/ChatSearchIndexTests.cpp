@@ -0,0 +1,253 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Data/ChatSearchIndex.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ChatSearchIndexTests
+{
+	constexpr int32 NumWords = 200;
+	constexpr int32 NumSenders = 20;
+
+	/** A vocabulary word, skewed so a few words are common and most are rare */
+	FString RandomWord(FRandomStream& Random)
+	{
+		const int32 Word = Random.RandRange(0, Random.RandRange(0, NumWords - 1));
+		return FString::Printf(Random.FRand() < 0.2f ? TEXT("Word%d") : TEXT("word%d"), Word);
+	}
+
+	FChatMessage MakeMessage(FRandomStream& Random, int64 SequenceId)
+	{
+		FChatMessage Message;
+		Message.SequenceId = SequenceId;
+		Message.SenderName = FString::Printf(TEXT("Player %d"), Random.RandRange(0, NumSenders - 1));
+
+		const int32 NumMessageWords = Random.RandRange(1, 8);
+		for (int32 i = 0; i < NumMessageWords; ++i)
+		{
+			Message.Content += RandomWord(Random);
+			Message.Content += Random.FRand() < 0.2f ? TEXT(", ") : TEXT(" ");
+		}
+		return Message;
+	}
+
+	/** Whole-word, case-insensitive match, written independently of FChatSearchIndex::Tokenize */
+	bool ContainsWord(const FString& Content, const FString& Word)
+	{
+		TArray<FString> Parts;
+		Content.ParseIntoArray(Parts, TEXT(" "));
+		for (FString& Part : Parts)
+		{
+			Part.RemoveFromEnd(TEXT(","));
+			if (Part.Equals(Word, ESearchCase::IgnoreCase))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Sequence ids of every retained message matching all query terms, oldest first */
+	TArray<int64> BruteForceSearch(const TArray<FChatMessage>& Retained, const TArray<FString>& Words, const FString& Sender)
+	{
+		TArray<int64> Matches;
+		for (const FChatMessage& Message : Retained)
+		{
+			bool bMatch = Sender.IsEmpty() || Message.SenderName.Replace(TEXT(" "), TEXT("")).Equals(Sender, ESearchCase::IgnoreCase);
+			for (int32 i = 0; i < Words.Num() && bMatch; ++i)
+			{
+				bMatch = ContainsWord(Message.Content, Words[i]);
+			}
+			if (bMatch)
+			{
+				Matches.Add(Message.SequenceId);
+			}
+		}
+		return Matches;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatSearchIndexMatchesBruteForceTest, "ChatSystem.SearchIndex.MatchesBruteForce", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatSearchIndexMatchesBruteForceTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatSearchIndexTests;
+
+	constexpr int32 Capacity = 1000;
+	constexpr int32 NumMessages = 5000;
+	FRandomStream Random(99);
+
+	FChatSearchIndex Index;
+	TArray<FChatMessage> Retained;
+	int32 NumMismatches = 0;
+
+	for (int64 SequenceId = 1; SequenceId <= NumMessages; ++SequenceId)
+	{
+		// Slides like the history it indexes: oldest out, newest in
+		if (Retained.Num() == Capacity)
+		{
+			Index.Remove(Retained[0]);
+			Retained.RemoveAt(0);
+		}
+		Retained.Add(MakeMessage(Random, SequenceId));
+		Index.Add(Retained.Last());
+
+		if (SequenceId % 50 != 0)
+		{
+			continue;
+		}
+
+		for (int32 QueryIndex = 0; QueryIndex < 10; ++QueryIndex)
+		{
+			TArray<FString> Words;
+			const int32 NumQueryWords = Random.RandRange(0, 3);
+			for (int32 i = 0; i < NumQueryWords; ++i)
+			{
+				Words.Add(RandomWord(Random));
+			}
+			const FString Sender = Words.Num() == 0 || Random.FRand() < 0.2f ? FString::Printf(TEXT("player%d"), Random.RandRange(0, NumSenders - 1)) : FString();
+
+			FString Query = FString::Join(Words, TEXT(" "));
+			if (!Sender.IsEmpty())
+			{
+				Query += FString::Printf(TEXT(" %s%s"), FChatSearchIndex::SenderPrefix, *Sender);
+			}
+
+			const TArray<int64> Expected = BruteForceSearch(Retained, Words, Sender);
+
+			// Everything, then only the newest few, then with a filter
+			TArray<int64> Found;
+			Index.Search(Query, Capacity, [](int64) { return true; }, Found);
+			if (Found != Expected)
+			{
+				AddError(FString::Printf(TEXT("'%s': found %d, expected %d"), *Query, Found.Num(), Expected.Num()));
+				++NumMismatches;
+			}
+
+			constexpr int32 MaxResults = 5;
+			Index.Search(Query, MaxResults, [](int64) { return true; }, Found);
+			const TArray<int64> Newest(Expected.GetData() + FMath::Max(0, Expected.Num() - MaxResults), FMath::Min(Expected.Num(), MaxResults));
+			if (Found != Newest)
+			{
+				AddError(FString::Printf(TEXT("'%s': newest %d differ"), *Query, MaxResults));
+				++NumMismatches;
+			}
+
+			Index.Search(Query, Capacity, [](int64 Id) { return Id % 2 == 0; }, Found);
+			if (Found != Expected.FilterByPredicate([](int64 Id) { return Id % 2 == 0; }))
+			{
+				AddError(FString::Printf(TEXT("'%s': filtered results differ"), *Query));
+				++NumMismatches;
+			}
+		}
+
+		if (NumMismatches > 10)
+		{
+			break;
+		}
+	}
+	TestEqual(TEXT("Mismatched queries"), NumMismatches, 0);
+
+	// Draining the window leaves nothing behind
+	for (const FChatMessage& Message : Retained)
+	{
+		Index.Remove(Message);
+	}
+	TestEqual(TEXT("Every term is removed with its last message"), Index.GetNumTerms(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatSearchIndexUnindexableTermTest, "ChatSystem.SearchIndex.UnindexableTerm", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatSearchIndexUnindexableTermTest::RunTest(const FString& Parameters)
+{
+	const FString LongWord = FString::ChrN(40, TEXT('a'));
+
+	FChatSearchIndex Index;
+	FChatMessage Message;
+	Message.SequenceId = 1;
+	Message.SenderName = TEXT("Player");
+	Message.Content = TEXT("hello ") + LongWord;
+	Index.Add(Message);
+
+	TArray<int64> Found;
+	Index.Search(TEXT("hello"), 10, [](int64) { return true; }, Found);
+	TestEqual(TEXT("Indexed word still matches"), Found.Num(), 1);
+
+	Index.Search(TEXT("hello ") + LongWord, 10, [](int64) { return true; }, Found);
+	TestEqual(TEXT("Query with a word too long to index finds nothing"), Found.Num(), 0);
+
+	Index.Search(TEXT("hello-") + LongWord, 10, [](int64) { return true; }, Found);
+	TestEqual(TEXT("Also when the long word is part of a larger query term"), Found.Num(), 0);
+
+	TArray<FString> Tokens;
+	TestFalse(TEXT("Tokenize reports the dropped word"), FChatSearchIndex::Tokenize(TEXT("Hello ") + LongWord + TEXT(" hello"), Tokens));
+	TestEqual(TEXT("Remaining words are still returned once"), Tokens, TArray<FString>({ TEXT("hello") }));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatSearchIndexPerfTest, "ChatSystem.SearchIndex.Perf100k", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FChatSearchIndexPerfTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatSearchIndexTests;
+
+	constexpr int32 NumMessages = 100000;
+	constexpr int32 NumQueries = 1000;
+	FRandomStream Random(5);
+
+	TArray<FChatMessage> Messages;
+	Messages.Reserve(NumMessages);
+	for (int32 i = 0; i < NumMessages; ++i)
+	{
+		Messages.Add(MakeMessage(Random, i + 1));
+	}
+
+	FChatSearchIndex Index;
+	double StartTime = FPlatformTime::Seconds();
+	for (const FChatMessage& Message : Messages)
+	{
+		Index.Add(Message);
+	}
+	const double AddMicros = (FPlatformTime::Seconds() - StartTime) * 1000000.0 / NumMessages;
+
+	TArray<FString> Queries;
+	for (int32 i = 0; i < NumQueries; ++i)
+	{
+		Queries.Add(i % 4 == 0
+			? FString::Printf(TEXT("%s from:player%d"), *RandomWord(Random), Random.RandRange(0, NumSenders - 1))
+			: FString::Printf(TEXT("%s %s"), *RandomWord(Random), *RandomWord(Random)));
+	}
+
+	TArray<int64> Found;
+	int64 NumFound = 0;
+	TArray<double> Latencies;
+	for (const FString& Query : Queries)
+	{
+		StartTime = FPlatformTime::Seconds();
+		Index.Search(Query, 50, [](int64) { return true; }, Found);
+		Latencies.Add((FPlatformTime::Seconds() - StartTime) * 1000000.0);
+		NumFound += Found.Num();
+	}
+	Latencies.Sort();
+
+	StartTime = FPlatformTime::Seconds();
+	for (const FChatMessage& Message : Messages)
+	{
+		Index.Remove(Message);
+	}
+	const double RemoveMicros = (FPlatformTime::Seconds() - StartTime) * 1000000.0 / NumMessages;
+
+	AddInfo(FString::Printf(TEXT("%d messages: add %.2f us, remove %.2f us per message"), NumMessages, AddMicros, RemoveMicros));
+	AddInfo(FString::Printf(TEXT("%d queries (up to 50 results, %lld found): median %.1f us, p99 %.1f us, max %.1f us"),
+		NumQueries, NumFound, Latencies[NumQueries / 2], Latencies[NumQueries * 99 / 100], Latencies.Last()));
+	TestEqual(TEXT("Index is empty after removing everything"), Index.GetNumTerms(), 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
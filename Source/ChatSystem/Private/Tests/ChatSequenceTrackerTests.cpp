@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Data/ChatSequenceTracker.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatSequenceTrackerSparseTest, "ChatSystem.SequenceTracker.SparseIds", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatSequenceTrackerSparseTest::RunTest(const FString& Parameters)
+{
+	// One client sees a sparse subset of the server's ids; most go to other channels and players
+	FChatSequenceTracker Tracker;
+	double Now = 100.0;
+	for (int64 Sequence = 1000; Sequence <= 20000; Sequence += 500)
+	{
+		Tracker.Accept(Sequence, Now);
+		Now += 0.1;
+	}
+	TestEqual(TEXT("Highest"), Tracker.GetHighest(), 20000LL);
+
+	// Far behind the newest id, but only a few deliveries old
+	TestTrue(TEXT("Redundant copy of an old id is a duplicate"), Tracker.Accept(15000, Now) == EChatSequenceResult::Duplicate);
+	TestTrue(TEXT("Never seen late id is reordered, not stale"), Tracker.Accept(15250, Now) == EChatSequenceResult::Reordered);
+	TestTrue(TEXT("Its own copy is then a duplicate"), Tracker.Accept(15250, Now) == EChatSequenceResult::Duplicate);
+	TestTrue(TEXT("Very first id is still remembered"), Tracker.Accept(1000, Now) == EChatSequenceResult::Duplicate);
+	TestTrue(TEXT("Id below the first seen was never seen"), Tracker.Accept(999, Now) == EChatSequenceResult::Reordered);
+
+	TestTrue(TEXT("Newer id"), Tracker.Accept(20001, Now) == EChatSequenceResult::New);
+	TestTrue(TEXT("Newer id twice"), Tracker.Accept(20001, Now) == EChatSequenceResult::Duplicate);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatSequenceTrackerForgetTest, "ChatSystem.SequenceTracker.Forget", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatSequenceTrackerForgetTest::RunTest(const FString& Parameters)
+{
+	{
+		// Ids are forgotten after RetentionSeconds
+		FChatSequenceTracker Tracker;
+		Tracker.Accept(10, 0.0);
+		Tracker.Accept(20, 1.0);
+		const double Later = 0.5 + FChatSequenceTracker::RetentionSeconds;
+		TestTrue(TEXT("New id after the first expired"), Tracker.Accept(30, Later) == EChatSequenceResult::New);
+		TestEqual(TEXT("Expired id forgotten"), Tracker.NumRemembered(), 2);
+		TestTrue(TEXT("Forgotten id can't be judged"), Tracker.Accept(10, Later) == EChatSequenceResult::Stale);
+		TestTrue(TEXT("Below a forgotten id can't be judged either"), Tracker.Accept(5, Later) == EChatSequenceResult::Stale);
+		TestTrue(TEXT("Id still remembered"), Tracker.Accept(20, Later) == EChatSequenceResult::Duplicate);
+		TestTrue(TEXT("Never seen id above everything forgotten"), Tracker.Accept(15, Later) == EChatSequenceResult::Reordered);
+	}
+
+	{
+		// Never more than MaxRemembered ids, oldest forgotten first
+		FChatSequenceTracker Tracker;
+		const int64 Count = FChatSequenceTracker::MaxRemembered + 10;
+		for (int64 Sequence = 1; Sequence <= Count; ++Sequence)
+		{
+			Tracker.Accept(Sequence * 2, 0.0);
+		}
+		TestEqual(TEXT("Capped"), Tracker.NumRemembered(), FChatSequenceTracker::MaxRemembered);
+		TestTrue(TEXT("Oldest forgotten"), Tracker.Accept(2, 0.0) == EChatSequenceResult::Stale);
+		TestTrue(TEXT("Oldest remembered"), Tracker.Accept(22, 0.0) == EChatSequenceResult::Duplicate);
+		TestTrue(TEXT("Gap above the forgotten ids"), Tracker.Accept(23, 0.0) == EChatSequenceResult::Reordered);
+		TestEqual(TEXT("Still capped"), Tracker.NumRemembered(), FChatSequenceTracker::MaxRemembered);
+
+		Tracker.Reset();
+		TestEqual(TEXT("Reset forgets everything"), Tracker.NumRemembered(), 0);
+		TestTrue(TEXT("Nothing is stale after a reset"), Tracker.Accept(2, 0.0) == EChatSequenceResult::New);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
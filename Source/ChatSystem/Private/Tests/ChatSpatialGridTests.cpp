@@ -0,0 +1,99 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Routing/ChatSpatialGrid.h"
+#include "ChatComponent.h"
+#include "Math/RandomStream.h"
+#include "UObject/Package.h"
+#include "UObject/StrongObjectPtr.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatSpatialGridMatchesBruteForceTest, "ChatSystem.SpatialGrid.MatchesBruteForce", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatSpatialGridMatchesBruteForceTest::RunTest(const FString& Parameters)
+{
+	constexpr float CellSize = 1000.0f;
+	constexpr float WorldExtent = 20000.0f;
+	constexpr int32 NumComponents = 500;
+
+	FRandomStream Random(1234);
+
+	TArray<TStrongObjectPtr<UChatComponent>> Components;
+	TArray<FVector> Locations;
+	for (int32 i = 0; i < NumComponents; ++i)
+	{
+		Components.Emplace(NewObject<UChatComponent>(GetTransientPackage()));
+		Locations.Add(FVector(
+			Random.FRandRange(-WorldExtent, WorldExtent),
+			Random.FRandRange(-WorldExtent, WorldExtent),
+			Random.FRandRange(-2000.0f, 2000.0f)));
+	}
+
+	// Exactly on cell edges and corners, where an off-by-one cell range would miss them
+	Components.Emplace(NewObject<UChatComponent>(GetTransientPackage()));
+	Locations.Add(FVector(CellSize, 0.0f, 0.0f));
+	Components.Emplace(NewObject<UChatComponent>(GetTransientPackage()));
+	Locations.Add(FVector(-CellSize, -CellSize, 0.0f));
+	Components.Emplace(NewObject<UChatComponent>(GetTransientPackage()));
+	Locations.Add(FVector(0.0f, 0.0f, 0.0f));
+
+	FChatSpatialGrid Grid;
+	Grid.Reset(CellSize);
+	for (int32 i = 0; i < Components.Num(); ++i)
+	{
+		Grid.Add(Components[i].Get(), Locations[i]);
+	}
+	TestEqual(TEXT("Every component is in the grid"), Grid.Num(), Components.Num());
+
+	TArray<FVector> Centers = { FVector::ZeroVector, FVector(CellSize, CellSize, 0.0f), FVector(-CellSize * 0.5f, 0.0f, 500.0f) };
+	for (int32 i = 0; i < 100; ++i)
+	{
+		Centers.Add(FVector(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-1000.0f, 1000.0f)));
+	}
+
+	// Radius equal to, smaller than and larger than the cell size
+	const float Radii[] = { CellSize, CellSize * 0.3f, CellSize * 2.5f };
+
+	for (const float Radius : Radii)
+	{
+		for (const FVector& Center : Centers)
+		{
+			TSet<UChatComponent*> Expected;
+			for (int32 i = 0; i < Components.Num(); ++i)
+			{
+				if (FVector::DistSquared(Center, Locations[i]) <= Radius * Radius)
+				{
+					Expected.Add(Components[i].Get());
+				}
+			}
+
+			TSet<UChatComponent*> Found;
+			int32 NumVisits = 0;
+			Grid.ForEachInRadius(Center, Radius, [&Found, &NumVisits](UChatComponent* Component)
+			{
+				Found.Add(Component);
+				++NumVisits;
+			});
+
+			const FString Context = FString::Printf(TEXT("Radius %.0f at %s"), Radius, *Center.ToString());
+			TestEqual(Context + TEXT(": each recipient visited once"), NumVisits, Found.Num());
+			TestEqual(Context + TEXT(": same number of recipients"), Found.Num(), Expected.Num());
+			TestTrue(Context + TEXT(": same recipients"), Found.Includes(Expected));
+		}
+	}
+
+	// A rebuild replaces the previous snapshot
+	Grid.Reset(CellSize);
+	Grid.Add(Components[0].Get(), FVector::ZeroVector);
+	int32 NumAfterReset = 0;
+	Grid.ForEachInRadius(FVector::ZeroVector, WorldExtent * 2.0f, [&NumAfterReset](UChatComponent*)
+	{
+		++NumAfterReset;
+	});
+	TestEqual(TEXT("Only entries added since the reset are visited"), NumAfterReset, 1);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,186 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/ChatTestWorld.h"
+#include "Tests/ChatTestPlayerState.h"
+#include "ChatComponent.h"
+#include "ChatSubsystem.h"
+
+namespace ChatTeamRoutingTests
+{
+	/**
+	 * Queue every delivery in the recipient's outbound queue and moderate inline, so a send can be
+	 * checked by looking at who has something waiting
+	 */
+	void UseOutboundQueues(UChatSubsystem& Subsystem)
+	{
+		FChatSettings Settings = Subsystem.GetChatSettings();
+		Settings.bEnableOutboundBudget = true;
+		Settings.bAsyncModeration = false;
+		Settings.RateLimit.MessagesPerSecond = 100000.0f;
+		Settings.RateLimit.Burst = 100000;
+		Subsystem.SetChatSettings(Settings);
+	}
+
+	AChatTestPlayerState* SpawnTeamPlayer(ChatTests::FChatTestWorld& TestWorld, int32 TeamId)
+	{
+		UChatComponent* Component = TestWorld.SpawnPlayer(AChatTestPlayerState::StaticClass());
+		AChatTestPlayerState* PlayerState = Cast<AChatTestPlayerState>(Component->GetOwner());
+		PlayerState->TeamId = TeamId;
+		TestWorld.GetSubsystem()->RegisterChatComponent(Component);
+		return PlayerState;
+	}
+
+	EChatRejectReason SendChat(UChatSubsystem& Subsystem, APlayerState* Sender, EChatChannel Channel = EChatChannel::Team)
+	{
+		FChatMessage Message;
+		Message.Sender = Sender;
+		Message.SenderName = Sender->GetPlayerName();
+		Message.Channel = Channel;
+		Message.Content = TEXT("hello");
+		return Subsystem.SubmitMessage(Message, false);
+	}
+
+	/** Messages waiting for each player, in order */
+	TArray<int32> GetQueueDepths(const UChatSubsystem& Subsystem, const TArray<APlayerState*>& Players)
+	{
+		TArray<int32> Depths;
+		for (APlayerState* PlayerState : Players)
+		{
+			Depths.Add(Subsystem.GetOutboundStats(PlayerState).QueueDepth);
+		}
+		return Depths;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatTeamRoutingSwitchTest, "ChatSystem.TeamRouting.SwitchMidSession", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FChatTeamRoutingSwitchTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatTeamRoutingTests;
+
+	ChatTests::FChatTestWorld TestWorld;
+	UChatSubsystem* Subsystem = TestWorld.GetSubsystem();
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+	UseOutboundQueues(*Subsystem);
+
+	AChatTestPlayerState* A = SpawnTeamPlayer(TestWorld, 1);
+	AChatTestPlayerState* B = SpawnTeamPlayer(TestWorld, 1);
+	AChatTestPlayerState* C = SpawnTeamPlayer(TestWorld, 2);
+	AChatTestPlayerState* D = SpawnTeamPlayer(TestWorld, INDEX_NONE);
+	const TArray<APlayerState*> Players = { A, B, C, D };
+
+	TestEqual(TEXT("Team is read on registration"), Subsystem->GetPlayerTeamId(A), 1);
+	TestEqual(TEXT("No team is INDEX_NONE"), Subsystem->GetPlayerTeamId(D), static_cast<int32>(INDEX_NONE));
+	TestTrue(TEXT("Players without a team can't send team chat"), SendChat(*Subsystem, D) == EChatRejectReason::NotOnTeam);
+
+	TestTrue(TEXT("Team message accepted"), SendChat(*Subsystem, A) == EChatRejectReason::None);
+	TestEqual(TEXT("Only team 1 receives A's message"), GetQueueDepths(*Subsystem, Players), TArray<int32>({ 1, 1, 0, 0 }));
+
+	// B moves to team 2
+	B->TeamId = 2;
+	Subsystem->NotifyTeamChanged(B);
+	TestEqual(TEXT("B's switch is picked up"), Subsystem->GetPlayerTeamId(B), 2);
+	SendChat(*Subsystem, A);
+	TestEqual(TEXT("B no longer receives team 1"), GetQueueDepths(*Subsystem, Players), TArray<int32>({ 2, 1, 0, 0 }));
+	SendChat(*Subsystem, C);
+	TestEqual(TEXT("B receives team 2"), GetQueueDepths(*Subsystem, Players), TArray<int32>({ 2, 2, 1, 0 }));
+
+	// D joins team 1
+	D->TeamId = 1;
+	Subsystem->NotifyTeamChanged(D);
+	TestTrue(TEXT("D can send once on a team"), SendChat(*Subsystem, D) == EChatRejectReason::None);
+	TestEqual(TEXT("D joined team 1"), GetQueueDepths(*Subsystem, Players), TArray<int32>({ 3, 2, 1, 1 }));
+
+	// The index only changes when the subsystem is told
+	A->TeamId = 2;
+	TestEqual(TEXT("Unnotified switch is not seen"), Subsystem->GetPlayerTeamId(A), 1);
+	Subsystem->NotifyTeamChanged(A);
+	SendChat(*Subsystem, D);
+	TestEqual(TEXT("A left team 1"), GetQueueDepths(*Subsystem, Players), TArray<int32>({ 3, 2, 1, 2 }));
+	SendChat(*Subsystem, A);
+	TestEqual(TEXT("A is on team 2"), GetQueueDepths(*Subsystem, Players), TArray<int32>({ 4, 3, 2, 2 }));
+
+	// Leaving the session removes the player from its team
+	Subsystem->UnregisterChatComponent(C->FindComponentByClass<UChatComponent>());
+	TestEqual(TEXT("Unregistered players have no team"), Subsystem->GetPlayerTeamId(C), static_cast<int32>(INDEX_NONE));
+	SendChat(*Subsystem, B);
+	TestEqual(TEXT("Team 2 without C"), GetQueueDepths(*Subsystem, { A, B, D }), TArray<int32>({ 5, 4, 2 }));
+
+	// Leaving a team
+	D->TeamId = INDEX_NONE;
+	Subsystem->NotifyTeamChanged(D);
+	TestTrue(TEXT("No team chat after leaving the team"), SendChat(*Subsystem, D) == EChatRejectReason::NotOnTeam);
+	TestEqual(TEXT("Nobody received it"), GetQueueDepths(*Subsystem, { A, B, D }), TArray<int32>({ 5, 4, 2 }));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChatTeamRoutingBenchmarkTest, "ChatSystem.TeamRouting.Benchmark", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FChatTeamRoutingBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace ChatTeamRoutingTests;
+
+	ChatTests::FChatTestWorld TestWorld;
+	UChatSubsystem* Subsystem = TestWorld.GetSubsystem();
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+	UseOutboundQueues(*Subsystem);
+
+	constexpr int32 NumTeams = 16;
+	constexpr int32 PlayersPerTeam = 10;
+	constexpr int32 Rounds = 20;
+
+	TArray<APlayerState*> Players;
+	for (int32 Team = 0; Team < NumTeams; ++Team)
+	{
+		for (int32 i = 0; i < PlayersPerTeam; ++i)
+		{
+			Players.Add(SpawnTeamPlayer(TestWorld, Team));
+		}
+	}
+
+	auto TimeSends = [Subsystem, &Players](EChatChannel Channel)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Round = 0; Round < Rounds; ++Round)
+		{
+			for (APlayerState* Sender : Players)
+			{
+				SendChat(*Subsystem, Sender, Channel);
+			}
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1000000.0 / (Rounds * Players.Num());
+	};
+
+	// Each player receives every message from its own team and nothing else
+	const double TeamMicros = TimeSends(EChatChannel::Team);
+	int32 NumWrong = 0;
+	for (const int32 Depth : GetQueueDepths(*Subsystem, Players))
+	{
+		if (Depth != Rounds * PlayersPerTeam)
+		{
+			++NumWrong;
+		}
+	}
+	TestEqual(TEXT("Players with the wrong number of team messages"), NumWrong, 0);
+
+	// The same traffic on Global reaches all players, for comparison
+	const double GlobalMicros = TimeSends(EChatChannel::Global);
+
+	AddInfo(FString::Printf(TEXT("%d teams of %d: %.2f us per team message, %.2f us per global message"),
+		NumTeams, PlayersPerTeam, TeamMicros, GlobalMicros));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,35 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/CoreNet.h"
+#include "ChatTestPackageMap.generated.h"
+
+/**
+ * Package map for serialization tests: object references are written as indices into a table shared by
+ * the writer and the reader, so NetSerialize round trips without a connection
+ */
+UCLASS(Transient)
+class UChatTestPackageMap : public UPackageMap
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin UPackageMap interface
+	virtual bool SerializeObject(FArchive& Ar, UClass* InClass, UObject*& Obj, FNetworkGUID* OutNetGUID = nullptr) override
+	{
+		int32 Index = Ar.IsSaving() ? Objects.AddUnique(Obj) : INDEX_NONE;
+		Ar << Index;
+		if (Ar.IsLoading())
+		{
+			Obj = Objects.IsValidIndex(Index) ? Objects[Index].Get() : nullptr;
+		}
+		return true;
+	}
+	//~ End UPackageMap interface
+
+private:
+	UPROPERTY()
+	TArray<TObjectPtr<UObject>> Objects;
+};
@@ -0,0 +1,24 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerState.h"
+#include "Interfaces/ChatTeamProvider.h"
+#include "ChatTestPlayerState.generated.h"
+
+/**
+ * PlayerState with a plain team id, used by the automation tests to drive team routing
+ * UHT can't see classes behind WITH_DEV_AUTOMATION_TESTS, so this one is always compiled
+ */
+UCLASS(NotPlaceable, Transient)
+class AChatTestPlayerState : public APlayerState, public IChatTeamProvider
+{
+	GENERATED_BODY()
+
+public:
+	/** Team reported to the chat subsystem; call UChatSubsystem::NotifyTeamChanged after changing it */
+	int32 TeamId = INDEX_NONE;
+
+	virtual int32 GetChatTeamId_Implementation() const override { return TeamId; }
+};
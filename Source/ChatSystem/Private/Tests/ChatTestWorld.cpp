@@ -0,0 +1,66 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Tests/ChatTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ChatComponent.h"
+#include "ChatSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerState.h"
+
+namespace ChatTests
+{
+	FChatTestWorld::FChatTestWorld()
+	{
+		// Creates a world and world context, then initializes game instance subsystems
+		GameInstance.Reset(NewObject<UGameInstance>(GEngine));
+		GameInstance->InitializeStandalone();
+		GetWorld()->SetGameMode(FURL());
+	}
+
+	FChatTestWorld::~FChatTestWorld()
+	{
+		UWorld* World = GetWorld();
+
+		// Subsystems go first; they still clean up actors in the world
+		GameInstance->Shutdown();
+		if (World)
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+	}
+
+	UWorld* FChatTestWorld::GetWorld() const
+	{
+		return GameInstance->GetWorld();
+	}
+
+	UChatSubsystem* FChatTestWorld::GetSubsystem() const
+	{
+		return GameInstance->GetSubsystem<UChatSubsystem>();
+	}
+
+	UChatComponent* FChatTestWorld::SpawnPlayer(TSubclassOf<APlayerState> PlayerStateClass)
+	{
+		APlayerState* PlayerState = GetWorld()->SpawnActor<APlayerState>(PlayerStateClass ? *PlayerStateClass : APlayerState::StaticClass());
+		return PlayerState ? NewObject<UChatComponent>(PlayerState) : nullptr;
+	}
+
+	UChatComponent* FChatTestWorld::SpawnPlayingPlayer(TSubclassOf<APlayerState> PlayerStateClass)
+	{
+		UChatComponent* Component = SpawnPlayer(PlayerStateClass);
+		if (Component)
+		{
+			// The world never begins play, so start the PlayerState by hand; it starts its registered components
+			Component->RegisterComponent();
+			Component->GetOwner()->DispatchBeginPlay();
+		}
+		return Component;
+	}
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
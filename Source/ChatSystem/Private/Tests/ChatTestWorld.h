@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/StrongObjectPtr.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class APlayerState;
+class UChatComponent;
+class UChatSubsystem;
+class UGameInstance;
+class UWorld;
+
+namespace ChatTests
+{
+	/**
+	 * Standalone game world with its own game instance, so the chat subsystem is created and initialized
+	 * the same way it is in a game. Everything is torn down when the fixture goes out of scope
+	 */
+	class FChatTestWorld
+	{
+	public:
+		FChatTestWorld();
+		~FChatTestWorld();
+
+		UWorld* GetWorld() const;
+		UChatSubsystem* GetSubsystem() const;
+
+		/**
+		 * Spawn a PlayerState carrying an unregistered ChatComponent
+		 * @param PlayerStateClass Class to spawn (defaults to APlayerState)
+		 * @return The component, owned by the new PlayerState
+		 */
+		UChatComponent* SpawnPlayer(TSubclassOf<APlayerState> PlayerStateClass = nullptr);
+
+		/**
+		 * Spawn a PlayerState whose ChatComponent has begun play, so it registers itself and keeps what it
+		 * receives the way it does in a game. Client RPCs run locally in a standalone world
+		 * @param PlayerStateClass Class to spawn (defaults to APlayerState)
+		 * @return The registered component, owned by the new PlayerState
+		 */
+		UChatComponent* SpawnPlayingPlayer(TSubclassOf<APlayerState> PlayerStateClass = nullptr);
+
+	private:
+		TStrongObjectPtr<UGameInstance> GameInstance;
+	};
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -5,9 +5,16 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Data/ChatMessage.h"
+#include "Data/ChatTokenBucket.h"
+#include "Data/ChatChannel.h"
+#include "Data/ChatHistoryReplication.h"
+#include "Data/ChatSequenceTracker.h"
+#include "Data/ChatMessageObjectPool.h"
+#include "Data/ChatMessageStore.h"
 #include "ChatComponent.generated.h"
 
 class UChatSubsystem;
+class UChatMessageDataObject;
 
 /**
  * Component that handles chat functionality for a player
@@ -29,6 +36,76 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Chat")
 	FOnChatMessageReceivedDelegate OnChatMessageReceived;
 
+	// Delegate for local notification of rejected messages
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnChatMessageRejectedDelegate, EChatRejectReason, Reason);
+
+	/** Broadcast when a message this client sent was rejected (use UChatSubsystem::GetRejectReasonText to display it) */
+	UPROPERTY(BlueprintAssignable, Category = "Chat")
+	FOnChatMessageRejectedDelegate OnChatMessageRejected;
+
+	// Delegate for ListView-ready message objects
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnChatMessageObjectDelegate, UChatMessageDataObject*, MessageObject);
+
+	/**
+	 * Broadcast when a received message is wrapped in a data object, after OnChatMessageReceived
+	 * Objects are recycled: stop using an object once OnChatMessageObjectRemoved fires for it
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "Chat")
+	FOnChatMessageObjectDelegate OnChatMessageObjectAdded;
+
+	/** Broadcast when a data object scrolls out of the retained window (remove it from the ListView) */
+	UPROPERTY(BlueprintAssignable, Category = "Chat")
+	FOnChatMessageObjectDelegate OnChatMessageObjectRemoved;
+
+	/** Number of received messages kept as data objects; the oldest are recycled beyond this (0 = create none) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat", meta = (ClampMin = "0"))
+	int32 MaxRetainedClientMessages = 100;
+
+	/**
+	 * Get the data objects of the retained messages, oldest first
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	TArray<UChatMessageDataObject*> GetRetainedMessageObjects() const;
+
+	/**
+	 * Get data object pool hit and miss counters
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	FChatMessagePoolStats GetMessagePoolStats() const { return MessageObjectPool.GetStats(); }
+
+	// Delegate for batched message store changes
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnChatStoreChangedDelegate, const TArray<FChatStoreChange>&, Changes);
+
+	/** Broadcast at most once per frame with the ranges appended to and evicted from the message store */
+	UPROPERTY(BlueprintAssignable, Category = "Chat")
+	FOnChatStoreChangedDelegate OnChatStoreChanged;
+
+	/** Received messages kept per channel in the message store (0 = don't store messages) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat", meta = (ClampMin = "0"))
+	int32 MaxStoredMessagesPerChannel = 200;
+
+	/**
+	 * Get the range of absolute indices currently stored for a channel
+	 * @param Channel The channel
+	 * @param OutFirstIndex Receives the index of the oldest stored message
+	 * @param OutEndIndex Receives the index one past the newest stored message
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	void GetStoredMessageBounds(EChatChannel Channel, int64& OutFirstIndex, int64& OutEndIndex) const;
+
+	/**
+	 * Copy stored messages by absolute index, e.g. the rows a virtualized list is showing
+	 * @param Channel The channel
+	 * @param FirstIndex Absolute index of the first message
+	 * @param Count Number of messages
+	 * @return The messages still stored in that range, oldest first
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	TArray<FChatMessage> GetStoredMessages(EChatChannel Channel, int64 FirstIndex, int32 Count) const;
+
+	/** Get the client-side message store, for copy-free access from C++ */
+	const FChatMessageStore& GetMessageStore() const { return MessageStore; }
+
 	/**
 	 * Send a chat message to the specified channel
 	 * @param Content The message content
@@ -53,7 +130,44 @@ public:
 	void SendProximityMessage(const FString& Content);
 
 	/**
-	 * Mute a specific player (local only, doesn't affect other players)
+	 * Send a message to a registered custom channel this player has joined
+	 * @param ChannelName The channel to send to
+	 * @param Content The message content
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	void SendChannelMessage(FName ChannelName, const FString& Content);
+
+	/**
+	 * Ask the server to join an open custom channel
+	 * @param ChannelName The channel to join
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	void JoinChannel(FName ChannelName);
+
+	/**
+	 * Leave a custom channel
+	 * @param ChannelName The channel to leave
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	void LeaveChannel(FName ChannelName);
+
+	/**
+	 * Get the custom channels this client is a member of
+	 * @return Channel names mapped to channel ids
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	TMap<FName, int32> GetJoinedChannels() const { return JoinedChannels; }
+
+	// Delegate for channel membership changes
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnChatChannelMembershipChangedDelegate, FName, ChannelName, bool, bJoined);
+
+	/** Broadcast on this client when it joins or leaves a custom channel */
+	UPROPERTY(BlueprintAssignable, Category = "Chat")
+	FOnChatChannelMembershipChangedDelegate OnChannelMembershipChanged;
+
+	/**
+	 * Mute a specific player (doesn't affect other players)
+	 * If bMirrorMutesToServer is set, the server also stops sending this player's messages to us
 	 * @param PlayerToMute The player to mute
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Chat")
@@ -87,6 +201,88 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Chat")
 	void ClearMutedPlayers();
 
+	/**
+	 * Check if the server has been told to drop messages from a sender for this recipient
+	 * Server only; called by the subsystem during routing for senders someone has muted
+	 * @param SenderKey The sender's UChatSubsystem::GetPlayerKey
+	 * @return True if the message should not be sent to this component
+	 */
+	bool IsSenderMutedOnServer(int32 SenderKey) const;
+
+	/** Player keys this component has muted on the server (server only) */
+	const TArray<int32>& GetServerMutedPlayerKeys() const { return ServerMutedPlayerKeys; }
+
+	/**
+	 * Check if this component is subscribed to a custom channel (server only)
+	 * @param ChannelId The channel to check
+	 */
+	bool IsSubscribedToChannel(int32 ChannelId) const
+	{
+		return ChannelSubscriptions.IsValidIndex(ChannelId) && ChannelSubscriptions[ChannelId];
+	}
+
+	/**
+	 * Set or clear a channel subscription bit (server only, called by the subsystem)
+	 * @param ChannelId The channel
+	 * @param bSubscribed Whether the component is subscribed
+	 */
+	void SetChannelSubscription(int32 ChannelId, bool bSubscribed);
+
+	/** Get the server-side channel subscription bitmask */
+	const TBitArray<>& GetChannelSubscriptions() const { return ChannelSubscriptions; }
+
+	/**
+	 * Client RPC to tell the client it joined or left a custom channel
+	 * @param ChannelId The channel's id
+	 * @param ChannelName The channel's name
+	 * @param bJoined True if joined, false if left
+	 */
+	UFUNCTION(Client, Reliable)
+	void ClientNotifyChannelMembership(int32 ChannelId, FName ChannelName, bool bJoined);
+
+	/**
+	 * Start the replicated history for this component (server only, called by the subsystem on registration)
+	 * @param SessionId Identifies the server's message history
+	 * @param EndSequence First sequence id this component receives live rather than through history
+	 */
+	void BeginHistoryReplication(const FGuid& SessionId, int64 EndSequence);
+
+	/**
+	 * Append a message to the history replicated to the owning client (server only)
+	 * @param Message The historical message
+	 */
+	void AddHistoryEntry(const FChatMessage& Message);
+
+	/**
+	 * Handle a history message that arrived through replication (client only)
+	 * @param Message The historical message
+	 */
+	void HandleHistoryMessage(const FChatMessage& Message);
+
+	/**
+	 * Handle a message multicast to every client through the broadcast relay (client only)
+	 * @param Message The broadcast message
+	 */
+	void HandleBroadcastMessage(const FChatMessage& Message);
+
+	/**
+	 * Ask the server for the history this client missed while away (client only, sent once)
+	 * Called from BeginPlay and retried briefly while the owning PlayerController is still replicating;
+	 * games that know sooner can call it from their PlayerState's OnRep_Owner or PlayerController's BeginPlay
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	void RequestMissedHistory();
+
+	/**
+	 * Get how many received messages were dropped because they had already arrived (including redundant unreliable copies)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	int64 GetDuplicateMessageCount() const { return NumDuplicateMessages; }
+
+	/** Mirror mutes to the server so muted players' messages are never sent (local muting still applies either way) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat")
+	bool bMirrorMutesToServer = true;
+
 	/**
 	 * Client RPC to receive a message from server
 	 * Public so ChatSubsystem can call it
@@ -95,33 +291,144 @@ public:
 	UFUNCTION(Client, Reliable)
 	void ClientReceiveMessage(const FChatMessage& Message);
 
+	/**
+	 * Client RPC to receive several messages from server in one call
+	 * Used when message batching is enabled; OnChatMessageReceived still fires once per message
+	 * @param Messages The messages to receive, in send order
+	 */
+	UFUNCTION(Client, Reliable)
+	void ClientReceiveMessageBatch(const TArray<FChatMessage>& Messages);
+
+	/**
+	 * Unreliable counterpart of ClientReceiveMessage, for channels with an unreliable delivery policy
+	 * Redundant copies of a message are dropped as duplicates
+	 * @param Message The message to receive
+	 */
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveMessageUnreliable(const FChatMessage& Message);
+
+	/**
+	 * Unreliable counterpart of ClientReceiveMessageBatch
+	 * @param Messages The messages to receive
+	 */
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveMessageBatchUnreliable(const TArray<FChatMessage>& Messages);
+
+	/**
+	 * Client RPC to notify of message send failure
+	 * Public so ChatSubsystem can report rejections that happen after asynchronous moderation
+	 * @param Reason The reason the message was rejected
+	 */
+	UFUNCTION(Client, Reliable)
+	void ClientNotifyMessageRejected(EChatRejectReason Reason);
+
 protected:
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/**
+	 * Server RPC to start replicating the history this client missed
+	 * @param KnownSessionId History session the client last received history from
+	 * @param AfterSequence Highest sequence id the client already has for that session
+	 */
+	UFUNCTION(Server, Reliable)
+	void ServerRequestHistory(FGuid KnownSessionId, int64 AfterSequence);
 
 	/**
 	 * Server RPC to send a message
 	 * @param Content The message content
 	 * @param Channel The channel to send to
 	 * @param WhisperTarget Optional target for whisper messages
+	 * @param CustomChannelId Registered channel id for Custom messages
 	 */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerSendMessage(const FString& Content, EChatChannel Channel, APlayerState* WhisperTarget);
+	void ServerSendMessage(const FString& Content, EChatChannel Channel, APlayerState* WhisperTarget, int32 CustomChannelId);
 
 	/**
-	 * Client RPC to notify of message send failure
-	 * @param Reason The reason the message failed
+	 * Server RPC to join an open custom channel
+	 * @param ChannelName The channel to join
 	 */
-	UFUNCTION(Client, Reliable)
-	void ClientNotifyMessageFailed(const FString& Reason);
+	UFUNCTION(Server, Reliable)
+	void ServerJoinChannel(FName ChannelName);
+
+	/**
+	 * Server RPC to leave a custom channel
+	 * @param ChannelName The channel to leave
+	 */
+	UFUNCTION(Server, Reliable)
+	void ServerLeaveChannel(FName ChannelName);
+
+	/**
+	 * Server RPC to mirror a local mute or unmute
+	 * @param Player The player being muted or unmuted
+	 * @param bMuted Whether the player is now muted
+	 */
+	UFUNCTION(Server, Reliable)
+	void ServerSetPlayerMuted(APlayerState* Player, bool bMuted);
+
+	/**
+	 * Server RPC to mirror clearing all local mutes
+	 */
+	UFUNCTION(Server, Reliable)
+	void ServerClearMutedPlayers();
 
 private:
 	/** List of players this client has muted (local only) */
 	UPROPERTY()
 	TArray<TObjectPtr<APlayerState>> MutedPlayers;
 
-	/** Timestamp of last message sent (for rate limiting) */
-	float LastMessageTime;
+	/** Custom channels this client has joined, by name (client side) */
+	TMap<FName, int32> JoinedChannels;
+
+	/** One bit per custom channel id this component is subscribed to (server side) */
+	TBitArray<> ChannelSubscriptions;
+
+	/** Server history session the replicated history belongs to */
+	UPROPERTY(Replicated)
+	FGuid HistorySessionId;
+
+	/** History missed before joining, filled a few entries per tick by the subsystem */
+	UPROPERTY(Replicated)
+	FChatHistoryArray ReplicatedHistory;
+
+	/** First history sequence delivered live; 0 once the client has requested its history (server side) */
+	int64 HistorySyncEnd = 0;
+
+	/** True once ServerRequestHistory went out (client side) */
+	bool bHistoryRequested = false;
+
+	/** Retries RequestMissedHistory until it is known whether the local player owns this component */
+	FTimerHandle HistoryRequestTimer;
+
+	/** Retries left before giving up on HistoryRequestTimer */
+	int32 HistoryRequestRetriesLeft = 0;
+
+	/** Recently received sequence ids per channel, to drop messages that arrive twice (client side) */
+	FChatSequenceTracker SequenceTrackers[NumChatChannels];
+
+	/** Data objects for the retained window of received messages, recycled as messages scroll out (client side) */
+	UPROPERTY(Transient)
+	FChatMessageObjectPool MessageObjectPool;
+
+	/** Bounded per-channel store of received messages (client side) */
+	UPROPERTY(Transient)
+	FChatMessageStore MessageStore;
+
+	/** True while a BroadcastStoreChanges is scheduled for next tick */
+	bool bStoreChangesPending = false;
+
+	/** Broadcast OnChatStoreChanged for everything stored since the last broadcast */
+	void BroadcastStoreChanges();
+
+	/** Messages dropped by SequenceTrackers */
+	int64 NumDuplicateMessages = 0;
+
+	/** Player keys this client has muted, mirrored on the server and kept sorted for binary search */
+	TArray<int32> ServerMutedPlayerKeys;
+
+	/** Local token buckets mirroring the server rate limit, so obviously rejected messages never leave the client */
+	FChatRateLimitSlot LocalRateLimit;
 
 	/** Cached reference to chat subsystem */
 	UPROPERTY()
@@ -133,6 +440,19 @@ private:
 	/** Get the owning PlayerState */
 	APlayerState* GetOwningPlayerState() const;
 
+	/**
+	 * Work out whether a local PlayerController owns this component's PlayerState
+	 * @param bOutKnown False while neither the PlayerState's owner nor the local controllers' PlayerStates have replicated
+	 * @return True if the owning player is local
+	 */
+	bool IsOwnedByLocalPlayer(bool& bOutKnown) const;
+
+	/**
+	 * Drop duplicates, filter and broadcast a single received message to local listeners
+	 * @param Message The received message
+	 */
+	void HandleReceivedMessage(const FChatMessage& Message);
+
 	/** Validate message before sending */
-	bool ValidateMessageLocally(const FString& Content, FString& OutFailureReason);
+	EChatRejectReason ValidateMessageLocally(const FString& Content, EChatChannel Channel);
 };
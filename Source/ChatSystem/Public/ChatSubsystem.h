@@ -4,11 +4,57 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "UObject/ObjectKey.h"
 #include "Data/ChatMessage.h"
+#include "Data/ChatMessageHistory.h"
+#include "Data/ChatSearchIndex.h"
+#include "Data/ChatTokenBucket.h"
+#include "Data/ChatChannel.h"
+#include "Routing/ChatSpatialGrid.h"
+#include "Routing/ChatOutboundQueue.h"
+#include "Moderation/ChatModerationPipeline.h"
 #include "ChatSubsystem.generated.h"
 
 class UChatComponent;
 class APlayerState;
+class FChatProfanityFilter;
+class FChatJournal;
+class AChatReplicationInfo;
+
+/**
+ * Messages queued for a single recipient while batching is enabled, or while its reliable buffer is near full
+ */
+USTRUCT()
+struct FChatPendingBatch
+{
+	GENERATED_BODY()
+
+	/** Messages for reliable channels waiting to be flushed, in send order */
+	UPROPERTY()
+	TArray<FChatMessage> Messages;
+
+	/** Messages for Unreliable channels waiting to be flushed */
+	UPROPERTY()
+	TArray<FChatMessage> UnreliableMessages;
+
+	/** Messages for UnreliableRedundant channels waiting to be flushed */
+	UPROPERTY()
+	TArray<FChatMessage> RedundantMessages;
+
+	/** UnreliableRedundant messages already sent once, sent again with the next flush */
+	UPROPERTY()
+	TArray<FChatMessage> RedundantCopies;
+
+	/** Number of messages waiting for their first send */
+	int32 NumQueued() const { return Messages.Num() + UnreliableMessages.Num() + RedundantMessages.Num(); }
+
+	/** Rough wire size of the queued messages (bytes) */
+	int32 EstimatedBytes = 0;
+
+	/** Reliable messages dropped from the front of Messages while held back, reported once sending resumes */
+	int32 NumSkipped = 0;
+};
 
 /**
  * Game Instance Subsystem that manages the chat system
@@ -16,19 +62,34 @@ class APlayerState;
  * Server-authoritative: all messages go through the server
  */
 UCLASS()
-class CHATSYSTEM_API UChatSubsystem : public UGameInstanceSubsystem
+class CHATSYSTEM_API UChatSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
 {
 	GENERATED_BODY()
 
 public:
 	UChatSubsystem();
 
+	// Delegate for moderation hooks on flagged messages
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnChatMessageFlaggedDelegate, const FChatMessage&, Message);
+
+	/** Broadcast on the server when the profanity filter flags a message (Flag mode) */
+	UPROPERTY(BlueprintAssignable, Category = "Chat")
+	FOnChatMessageFlaggedDelegate OnChatMessageFlagged;
+
 	// Subsystem lifecycle
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
 
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual bool IsTickableWhenPaused() const override { return true; }
+	virtual TStatId GetStatId() const override;
+
 	/**
 	 * Broadcast a message to relevant players
+	 * Moderation always runs inline, so the message has been routed (or rejected) when this returns
 	 * Should only be called on the server
 	 * @param Message The message to broadcast
 	 * @param OutFailureReason If validation fails, this will contain the reason
@@ -37,6 +98,24 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Chat")
 	bool BroadcastMessage(const FChatMessage& Message, FString& OutFailureReason);
 
+	/**
+	 * Validate, rate limit and route a message without formatting any failure text
+	 * When the message is moderated asynchronously, None means it was accepted for moderation; later
+	 * rejections are reported to the sender's ChatComponent
+	 * Should only be called on the server
+	 * @param Message The message to broadcast
+	 * @param bAllowAsyncModeration False to moderate inline even if bAsyncModeration is set
+	 * @return EChatRejectReason::None if the message was accepted, otherwise why it was rejected
+	 */
+	EChatRejectReason SubmitMessage(const FChatMessage& Message, bool bAllowAsyncModeration = true);
+
+	/**
+	 * Get user-facing text for a rejection reason
+	 * @param Reason The reason a message was rejected
+	 */
+	UFUNCTION(BlueprintPure, Category = "Chat")
+	static FText GetRejectReasonText(EChatRejectReason Reason);
+
 	/**
 	 * Send a system message to all players
 	 * @param Content The message content
@@ -53,6 +132,56 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Chat")
 	TArray<FChatMessage> GetRecentMessages(int32 Count = 50) const;
 
+	/**
+	 * Get archived messages timestamped within a time range (server only, needs bEnableJournal)
+	 * Only archived journal segments are searched; the live segment's messages are in GetRecentMessages
+	 * @param From Start of the range, inclusive
+	 * @param To End of the range, exclusive
+	 * @param MaxResults Maximum number of messages to return
+	 * @return Matching messages, oldest first (Sender is always null)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	TArray<FChatMessage> QueryArchivedMessages(const FDateTime& From, const FDateTime& To, int32 MaxResults = 100) const;
+
+	/**
+	 * Find retained history messages containing every word of a query (server only)
+	 * Matching is case-insensitive on whole words; a "from:Name" term matches the sender name
+	 * @param Query Words to search for, separated by spaces
+	 * @param Channel Only return messages from this channel
+	 * @param MaxResults Maximum number of messages to return, newest matches first
+	 * @param bAllChannels Search every channel instead of just Channel
+	 * @return Matching messages, oldest first
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	TArray<FChatMessage> SearchHistory(const FString& Query, EChatChannel Channel, int32 MaxResults = 50, bool bAllChannels = false) const;
+
+	/**
+	 * Queue retained history for replication to a late joiner (server only)
+	 * @param Component The late joiner's chat component
+	 * @param KnownSessionId History session the client last received history from
+	 * @param AfterSequence Highest sequence id the client already has; ignored if KnownSessionId is not this server's
+	 * @param EndSequence First sequence id the component receives live
+	 */
+	void RequestHistorySync(UChatComponent* Component, const FGuid& KnownSessionId, int64 AfterSequence, int64 EndSequence);
+
+	/**
+	 * Record a message received by the local client, so a reconnect only asks for newer history
+	 * @param SessionId History session the message came from
+	 * @param Sequence The message's sequence id
+	 */
+	void NoteReceivedSequence(const FGuid& SessionId, int64 Sequence);
+
+	/**
+	 * Get the newest message the local client has received
+	 * @param OutSessionId Receives the history session, invalid if nothing was received yet
+	 * @param OutSequence Receives the highest sequence id received from that session
+	 */
+	void GetKnownHistory(FGuid& OutSessionId, int64& OutSequence) const
+	{
+		OutSessionId = KnownHistorySessionId;
+		OutSequence = KnownHistorySequence;
+	}
+
 	/**
 	 * Clear all message history
 	 */
@@ -72,6 +201,132 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Chat")
 	void SetChatSettings(const FChatSettings& NewSettings);
 
+	/**
+	 * Rebuild the profanity filter from ProfanityWordListPath on a worker thread
+	 * The current filter stays in use until the new one is ready
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	void ReloadProfanityFilter();
+
+	/**
+	 * Replace the profanity filter with one built from the given words
+	 * @param Words The words to filter
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	void SetProfanityWordList(const TArray<FString>& Words);
+
+	/**
+	 * Re-read a player's team and update the team chat index (server only)
+	 * Call whenever a player's team changes
+	 * @param PlayerState The player whose team changed
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	void NotifyTeamChanged(APlayerState* PlayerState);
+
+	/**
+	 * Get the team id the chat system currently has for a player
+	 * @param PlayerState The player to look up
+	 * @return The team id, or INDEX_NONE if the player is not on a team
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	int32 GetPlayerTeamId(const APlayerState* PlayerState) const;
+
+	/**
+	 * Ask a PlayerState for its team (IChatTeamProvider, falling back to IGenericTeamAgentInterface)
+	 * Also used on clients, so team relays need the team to be replicated
+	 * @return The team id, or INDEX_NONE if the player is not on a team
+	 */
+	static int32 QueryTeamId(APlayerState* PlayerState);
+
+	/**
+	 * Register a custom channel (server only)
+	 * @param Definition The channel's name, policy and color (ChannelId is ignored)
+	 * @return The channel id, or the existing id if a channel with that name is already registered
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat|Channels")
+	int32 RegisterChannel(const FChatChannelDefinition& Definition);
+
+	/**
+	 * Remove a custom channel and drop all of its members (server only)
+	 * @param ChannelId The channel to remove
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat|Channels")
+	void UnregisterChannel(int32 ChannelId);
+
+	/**
+	 * Look up a custom channel by name
+	 * @param ChannelName The channel name
+	 * @return The channel id, or INDEX_NONE if no such channel is registered
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat|Channels")
+	int32 FindChannelId(FName ChannelName) const;
+
+	/**
+	 * Get a registered custom channel
+	 * @param ChannelId The channel id
+	 * @param OutDefinition Receives the channel definition
+	 * @return True if the channel exists
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat|Channels")
+	bool GetChannelDefinition(int32 ChannelId, FChatChannelDefinition& OutDefinition) const;
+
+	/**
+	 * Subscribe a player to a custom channel regardless of its policy (server only)
+	 * @param PlayerState The player to add
+	 * @param ChannelId The channel
+	 * @return True if the player is now a member
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat|Channels")
+	bool AddPlayerToChannel(APlayerState* PlayerState, int32 ChannelId);
+
+	/**
+	 * Unsubscribe a player from a custom channel (server only)
+	 * @param PlayerState The player to remove
+	 * @param ChannelId The channel
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat|Channels")
+	void RemovePlayerFromChannel(APlayerState* PlayerState, int32 ChannelId);
+
+	/**
+	 * Handle a player's own request to join a channel, enforcing its policy
+	 * @param PlayerState The player asking to join
+	 * @param ChannelName The channel to join
+	 * @return EChatRejectReason::None if the player joined (or already was a member)
+	 */
+	EChatRejectReason RequestJoinChannel(APlayerState* PlayerState, FName ChannelName);
+
+	/**
+	 * Send a server message to every member of a custom channel
+	 * @param ChannelId The channel
+	 * @param Content The message content
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat|Channels")
+	void BroadcastChannelMessage(int32 ChannelId, const FString& Content);
+
+	/**
+	 * Add a moderation stage, run after the profanity filter
+	 * @param Validator The validator to add (must be thread-safe)
+	 */
+	void AddMessageValidator(const TSharedRef<const IChatMessageValidator>& Validator);
+
+	/**
+	 * Remove a previously added moderation stage
+	 * @param Validator The validator to remove
+	 */
+	void RemoveMessageValidator(const TSharedRef<const IChatMessageValidator>& Validator);
+
+	/**
+	 * Get moderation queue depth, pipeline latency and per-validator timing
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	FChatModerationStats GetModerationStats() const { return ModerationPipeline.GetStats(); }
+
+	/**
+	 * Block until every message in the moderation queue has been processed and routed; rejections are reported to their senders
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	void FlushModerationQueue();
+
 	/**
 	 * Register a chat component (called automatically by components)
 	 * @param Component The component to register
@@ -89,14 +344,64 @@ public:
 	 */
 	const TArray<UChatComponent*>& GetRegisteredComponents() const { return RegisteredComponents; }
 
+	/**
+	 * Get the registered chat component for a player state, in O(1)
+	 * @param PlayerState The player state to get the component from
+	 * @return The chat component, or nullptr if not found
+	 */
+	UChatComponent* GetChatComponentForPlayer(APlayerState* PlayerState) const;
+
+	/**
+	 * Get the stable key used to identify a player in chat bookkeeping
+	 * Keys are handed out by the subsystem when a player's ChatComponent registers and are never reused,
+	 * unlike the PlayerId (still 0 when components register, and 0 for bots) or the object index
+	 * @param PlayerState The player to get the key for
+	 * @return The player's key, or INDEX_NONE if the player has no registered ChatComponent
+	 */
+	int32 GetPlayerKey(const APlayerState* PlayerState) const;
+
+	/**
+	 * Count a server-side mute of a player (called by ChatComponent)
+	 * @param PlayerKey The muted player's key
+	 */
+	void AddServerMute(int32 PlayerKey);
+
+	/**
+	 * Release a server-side mute of a player (called by ChatComponent)
+	 * @param PlayerKey The unmuted player's key
+	 */
+	void RemoveServerMute(int32 PlayerKey);
+
+	/**
+	 * Get counters for the batched delivery path
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	const FChatBatchingStats& GetBatchingStats() const { return BatchingStats; }
+
+	/**
+	 * Immediately flush every pending per-recipient batch
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	void FlushPendingBatches();
+
+	/**
+	 * Get a recipient's outbound queue counters (needs bEnableOutboundBudget)
+	 * @param PlayerState The recipient
+	 * @return Queue depth, messages sent and expired, and how long sent messages were queued
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Chat")
+	FChatOutboundStats GetOutboundStats(APlayerState* PlayerState) const;
+
+	/** Answers IsReliableBufferSaturated instead of the net connection when set; lets tests stand in for a congested client */
+	TFunction<bool(const UChatComponent*)> ReliableBufferSaturatedOverride;
+
 protected:
 	/**
 	 * Validate a message before broadcasting
 	 * @param Message The message to validate
-	 * @param OutFailureReason If validation fails, this will contain the reason
-	 * @return True if message is valid
+	 * @return EChatRejectReason::None if the message is valid, otherwise why it is not
 	 */
-	bool ValidateMessage(const FChatMessage& Message, FString& OutFailureReason);
+	EChatRejectReason ValidateMessage(const FChatMessage& Message);
 
 	/**
 	 * Send message to specific players based on channel type
@@ -110,6 +415,49 @@ protected:
 	 */
 	void SendToAllPlayers(const FChatMessage& Message);
 
+	/**
+	 * Multicast a Global or System message through the broadcast relay, if bUseBroadcastRelay allows it
+	 * @param Message The message to send
+	 * @return True if the relay sent it, false if it has to go to each player separately
+	 */
+	bool SendThroughRelay(const FChatMessage& Message);
+
+	/**
+	 * Get the broadcast relay for the current world, spawning it if needed (server only)
+	 * @return The relay, or nullptr on clients and without a world
+	 */
+	AChatReplicationInfo* GetBroadcastRelay();
+
+	/**
+	 * Multicast a team message through the team's relay, if bUseBroadcastRelay is set and the server uses Iris
+	 * Iris only replicates the relay to the team's connections, so it picks the recipients instead of a loop here
+	 * @param Message The message to send
+	 * @param TeamId The sender's team
+	 * @return True if the relay sent it, false if it has to go to each member separately
+	 */
+	bool SendThroughTeamRelay(const FChatMessage& Message, int32 TeamId);
+
+	/**
+	 * Get a team's relay, spawning it if needed (Iris servers with bUseBroadcastRelay only)
+	 * @param TeamId The team
+	 * @return The relay, or nullptr if team relays are not in use
+	 */
+	AChatReplicationInfo* GetTeamRelay(int32 TeamId);
+
+	/**
+	 * Point a team relay's Iris connection filter at the team's current members
+	 * @param TeamId The team whose membership changed
+	 * @return True if the filter now matches the members; until then the relay must not be used
+	 */
+	bool UpdateTeamRelayFilter(int32 TeamId);
+
+	/**
+	 * Multicast a message on a relay following its channel's delivery policy
+	 * @param Relay The relay to send through
+	 * @param Message The message to send
+	 */
+	void MulticastThroughRelay(AChatReplicationInfo* Relay, const FChatMessage& Message);
+
 	/**
 	 * Send message to players on the same team
 	 * @param Message The message to send
@@ -129,34 +477,333 @@ protected:
 	void SendToProximity(const FChatMessage& Message);
 
 	/**
-	 * Get the chat component for a player state
-	 * @param PlayerState The player state to get the component from
-	 * @return The chat component, or nullptr if not found
+	 * Send message to the members of its custom channel
+	 * @param Message The message to send
 	 */
-	UChatComponent* GetChatComponentForPlayer(APlayerState* PlayerState) const;
+	void SendToChannel(const FChatMessage& Message);
+
+	/**
+	 * Rebuild the proximity grid from current pawn positions if it is older than the refresh interval
+	 */
+	void RefreshProximityGrid();
 
 	/**
-	 * Add message to history
+	 * Deliver a message to a single recipient, either directly or through its pending batch
+	 * All routing paths go through here
+	 * @param Recipient The component that should receive the message
+	 * @param Message The message to deliver
+	 */
+	void DeliverMessage(UChatComponent* Recipient, const FChatMessage& Message);
+
+	/**
+	 * Send a recipient's queued messages and reset the batch
+	 * Reliable messages go out as one reliable RPC, the rest and last flush's redundant copies over the unreliable RPCs
+	 * @param Recipient The component to flush
+	 * @param Batch The recipient's pending batch
+	 */
+	void FlushBatch(UChatComponent* Recipient, FChatPendingBatch& Batch);
+
+	/**
+	 * Send a batch's reliable messages in MaxBatchSize chunks until the recipient's reliable buffer nears full
+	 * Whatever is left stays in Batch.Messages, trimmed to MaxReliableBacklog
+	 * @param Recipient The component to send to
+	 * @param Batch The recipient's pending batch
+	 */
+	void SendReliable(UChatComponent* Recipient, FChatPendingBatch& Batch);
+
+	/**
+	 * Check whether more reliable RPCs could overflow a recipient's reliable buffer and get it disconnected
+	 * @param Recipient The component to check
+	 * Only meaningful on the actor channel replication path; always false under Iris
+	 * @return True if the PlayerState's actor channel has ReliableBufferThreshold or more reliable bunches unacknowledged
+	 */
+	bool IsReliableBufferSaturated(const UChatComponent* Recipient) const;
+
+	/**
+	 * Send a message to one recipient now, through its channel's delivery policy and the batching path
+	 * @param Recipient The component to send to
+	 * @param Message The message to send
+	 */
+	void SendToRecipient(UChatComponent* Recipient, const FChatMessage& Message);
+
+	/**
+	 * Send what each recipient's budget allows from its outbound queue, dropping expired messages
+	 * @param bIgnoreBudget Send every message that has not expired
+	 */
+	void DrainOutboundQueues(bool bIgnoreBudget);
+
+	/**
+	 * Send messages over the unreliable RPCs, split so no RPC is estimated above MaxBatchBytes
+	 * Unreliable RPCs that need more than one packet are lost if any of their packets is
+	 * @param Recipient The component to send to
+	 * @param Messages The messages to send
+	 */
+	void SendUnreliable(UChatComponent* Recipient, const TArray<FChatMessage>& Messages);
+
+	/**
+	 * Assign the message its sequence id and add it to history
+	 * Every routed message goes through here right before RouteMessage
 	 * @param Message The message to add
 	 */
-	void AddToHistory(const FChatMessage& Message);
+	void AddToHistory(FChatMessage& Message);
 
 private:
 	/** Chat configuration settings */
 	UPROPERTY(EditAnywhere, Category = "Chat Settings")
 	FChatSettings ChatSettings;
 
-	/** Message history for late joiners */
+	/** Message history for late joiners (circular, capacity follows MaxHistorySize) */
 	UPROPERTY()
-	TArray<FChatMessage> MessageHistory;
+	FChatMessageHistory MessageHistory;
+
+	/** Word index over MessageHistory, kept in step with it by AddToHistory */
+	FChatSearchIndex SearchIndex;
+
+	/** Re-index every retained message, after history was trimmed other than by eviction */
+	void RebuildSearchIndex();
+
+	/** Identifies this server's message history, so reconnecting clients can tell if their sequence ids still apply */
+	FGuid HistorySessionId;
+
+	/** Sequence id for the next routed message */
+	int64 NextSequenceId = 1;
+
+	/** On-disk log of routed messages, open while bEnableJournal is set on the server */
+	TUniquePtr<FChatJournal> Journal;
+
+	/** True once the journal has been opened (or failed to open) with the current journal settings */
+	bool bJournalInitialized = false;
+
+	/**
+	 * Open the journal and restore history from it, once per journal settings, before the next message is sequenced
+	 * Does nothing on clients or when bEnableJournal is off
+	 */
+	void InitializeJournal();
+
+	/** Absolute path of the live journal segment; archives are stored next to it */
+	FString GetJournalPath() const;
+
+	/** A late joiner's history replication in progress */
+	struct FChatHistorySync
+	{
+		TWeakObjectPtr<UChatComponent> Component;
+
+		/** Next sequence id to replicate */
+		int64 NextSequence = 0;
+
+		/** Stop before this sequence; later messages were delivered live */
+		int64 EndSequence = 0;
+	};
+
+	/** History replications in progress */
+	TArray<FChatHistorySync> HistorySyncs;
+
+	/** Hand each late joiner its next few history entries */
+	void PumpHistorySync();
+
+	/**
+	 * Check if a recipient would have received a message had it been connected when it was sent
+	 * @param Recipient The late joiner
+	 * @param Message The historical message
+	 */
+	bool CanReceiveHistoryMessage(const UChatComponent* Recipient, const FChatMessage& Message) const;
+
+	/** History session and highest sequence id received by the local client */
+	FGuid KnownHistorySessionId;
+	int64 KnownHistorySequence = 0;
 
 	/** All registered chat components */
 	UPROPERTY()
 	TArray<TObjectPtr<UChatComponent>> RegisteredComponents;
 
-	/** Track last message time per player for rate limiting */
-	TMap<APlayerState*, float> PlayerMessageTimes;
+	/** Player key for each entry in RegisteredComponents (INDEX_NONE if not owned by a PlayerState) */
+	TArray<int32> RegisteredPlayerKeys;
 
-	/** Check if a player is rate limited */
-	bool IsPlayerRateLimited(APlayerState* PlayerState, FString& OutFailureReason);
+	/** Index into RegisteredComponents by player key, for O(1) whisper routing and registration */
+	TMap<int32, int32> ComponentIndexByPlayerKey;
+
+	/** Key handed out to each registered PlayerState; TObjectKey includes the serial number so a recycled object never matches */
+	TMap<TObjectKey<APlayerState>, int32> PlayerKeyByPlayerState;
+
+	/** Next key to hand out */
+	int32 NextPlayerKey = 0;
+
+	/**
+	 * Get a player's key, handing out a new one if it has none yet
+	 * @param PlayerState The player
+	 * @return The player's key, or INDEX_NONE if there is no player
+	 */
+	int32 AssignPlayerKey(const APlayerState* PlayerState);
+
+	/** Number of components muting each player key on the server, so routing skips the per-recipient check for everyone else */
+	TMap<int32, int32> ServerMuteCounts;
+
+	/**
+	 * Check whether a recipient has muted a sender on the server
+	 * @param Recipient The component the message would go to
+	 * @param Sender The sender of the message
+	 * @return True if the message should not be sent to this recipient
+	 */
+	bool IsMutedOnServer(const UChatComponent* Recipient, const APlayerState* Sender) const;
+
+	/** Remove a registered component by index and keep the player key index in sync */
+	void RemoveRegisteredComponentAt(int32 Index);
+
+	/** Check that RegisteredComponents, RegisteredPlayerKeys and ComponentIndexByPlayerKey agree */
+	bool IsComponentIndexConsistent() const;
+
+	/** Last routed sender name per player key, to spot renames */
+	struct FChatSenderName
+	{
+		FString Name;
+
+		/** World time of the last rename (negative = never renamed) */
+		double RenameTime = -1.0;
+	};
+	TMap<int32, FChatSenderName> SenderNameByPlayerKey;
+
+	/**
+	 * Record the name a player is sending under
+	 * @param PlayerKey The sender's key
+	 * @param SenderName The name on the message being routed
+	 * @return True if the player renamed recently, so the name should be sent explicitly
+	 */
+	bool NoteSenderName(int32 PlayerKey, const FString& SenderName);
+
+	/** Team id per player key, for players that are on a team */
+	TMap<int32, int32> TeamByPlayerKey;
+
+	/** Player keys of each team's members, so team chat only touches members */
+	TMap<int32, TArray<int32>> TeamMemberKeys;
+
+	/**
+	 * Move a player between team member lists
+	 * @param PlayerKey The player's key
+	 * @param NewTeamId The player's new team, or INDEX_NONE to remove them from team chat
+	 */
+	void SetPlayerTeam(int32 PlayerKey, int32 NewTeamId);
+
+	/** A registered custom channel and its members */
+	struct FChatChannelSlot
+	{
+		FChatChannelDefinition Definition;
+
+		/** Player keys of subscribed players */
+		TArray<int32> SubscriberKeys;
+
+		bool bActive = false;
+	};
+
+	/** Custom channels indexed by channel id */
+	TArray<FChatChannelSlot> ChannelSlots;
+
+	/** Channel ids freed by UnregisterChannel, reused by RegisterChannel */
+	TArray<int32> FreeChannelIds;
+
+	/** Channel id by name */
+	TMap<FName, int32> ChannelIdByName;
+
+	/** Get an active channel slot, or nullptr */
+	FChatChannelSlot* FindChannelSlot(int32 ChannelId);
+	const FChatChannelSlot* FindChannelSlot(int32 ChannelId) const;
+
+	/** Drop a component from every channel it is subscribed to */
+	void RemoveFromAllChannels(UChatComponent* Component, int32 PlayerKey);
+
+	/** Spatial index of pawn locations for proximity chat */
+	FChatSpatialGrid ProximityGrid;
+
+	/** World time of the last proximity grid build (negative = never built) */
+	double LastProximityGridBuildTime = -1.0;
+
+	/** Frame of the last proximity grid build */
+	uint64 LastProximityGridBuildFrame = 0;
+
+	/** Per-recipient message batches waiting to be flushed */
+	UPROPERTY()
+	TMap<TObjectPtr<UChatComponent>, FChatPendingBatch> PendingBatches;
+
+	/** Time accumulated since the last batch flush */
+	float TimeSinceLastFlush = 0.0f;
+
+	/** Multicasts Global and System messages while bUseBroadcastRelay is set */
+	UPROPERTY()
+	TObjectPtr<AChatReplicationInfo> BroadcastRelay;
+
+	/** Per-team relays, used on Iris servers while bUseBroadcastRelay is set */
+	UPROPERTY()
+	TMap<int32, TObjectPtr<AChatReplicationInfo>> TeamRelays;
+
+	/** Some relay holds redundant copies for the next flush */
+	bool bRelayCopiesPending = false;
+
+	/** Counters for the batched delivery path */
+	FChatBatchingStats BatchingStats;
+
+	/** Per-recipient priority queues, used while bEnableOutboundBudget is set */
+	UPROPERTY()
+	TMap<TObjectPtr<UChatComponent>, FChatOutboundQueue> OutboundQueues;
+
+	/** Messages waiting across all OutboundQueues */
+	int32 NumOutboundQueued = 0;
+
+	/** Messages handed to DeliverMessage and not dropped as muted, for per-route fan-out stats */
+	int32 NumDeliveries = 0;
+
+	/** Compiled profanity word list, swapped as a whole when reloaded */
+	TSharedPtr<const FChatProfanityFilter> ProfanityFilter;
+
+	/** Absolute path of the word list file for the current settings */
+	FString GetProfanityWordListFilePath() const;
+
+	/** Validators added through AddMessageValidator */
+	TArray<TSharedRef<const IChatMessageValidator>> CustomValidators;
+
+	/** Full validator chain captured by each moderation job; rebuilt whenever a stage changes */
+	TSharedPtr<const FChatValidatorList> ValidatorChain;
+
+	/** True if any stage of ValidatorChain asks to run off the game thread */
+	bool bValidatorChainRunsOffGameThread = false;
+
+	/** Runs validators off the game thread and releases results in per-sender order */
+	FChatModerationPipeline ModerationPipeline;
+
+	/** Rebuild ValidatorChain from the profanity filter settings and CustomValidators */
+	void RebuildValidatorChain();
+
+	/**
+	 * Route a message that finished moderation
+	 * @param Job The finished job
+	 * @return EChatRejectReason::None if the message was routed, otherwise why it was dropped
+	 */
+	EChatRejectReason FinishModeration(FChatModerationJob& Job);
+
+	/**
+	 * Route an asynchronously moderated message and report a rejection to its sender
+	 * @param Job The finished job
+	 */
+	void ReleaseModeratedMessage(FChatModerationJob& Job);
+
+	/** Rate limiting state for each entry in RegisteredComponents, kept in lockstep with it */
+	TArray<FChatRateLimitSlot> RateLimitSlots;
+
+	/** Rate limiting state for senders without an indexed component, created on their first message */
+	TMap<TObjectKey<APlayerState>, FChatRateLimitSlot> UnindexedRateLimitSlots;
+
+	/** World time UnindexedRateLimitSlots was last pruned */
+	double LastUnindexedRateLimitPruneTime = 0.0;
+
+	/**
+	 * Drop unindexed rate limit slots whose PlayerState is gone or whose buckets have refilled
+	 * @param Now Current world time
+	 */
+	void PruneUnindexedRateLimitSlots(double Now);
+
+	/**
+	 * Take a rate limit token for a player
+	 * @param PlayerState The sending player
+	 * @param Channel The channel being sent on
+	 * @return True if the player may send, false if rate limited
+	 */
+	bool ConsumeRateLimitToken(const APlayerState* PlayerState, EChatChannel Channel);
 };
@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+CHATSYSTEM_API DECLARE_LOG_CATEGORY_EXTERN(LogChat, Log, All);
+
 class FChatSystemModule : public IModuleInterface
 {
 public:
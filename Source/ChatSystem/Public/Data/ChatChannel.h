@@ -0,0 +1,46 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChatChannel.generated.h"
+
+/**
+ * Who may join and post in a custom channel
+ */
+UENUM(BlueprintType)
+enum class EChatChannelPolicy : uint8
+{
+	/** Players can join on their own and post once joined */
+	Open UMETA(DisplayName = "Open"),
+	/** Only the server can add players; members can post */
+	InviteOnly UMETA(DisplayName = "Invite Only"),
+	/** Only the server can add players and post (announcements, event feeds) */
+	ReadOnly UMETA(DisplayName = "Read Only")
+};
+
+/**
+ * A runtime-registered chat channel (guild, party, event, ...)
+ * Messages for these channels use EChatChannel::Custom and carry the ChannelId
+ */
+USTRUCT(BlueprintType)
+struct CHATSYSTEM_API FChatChannelDefinition
+{
+	GENERATED_BODY()
+
+	/** Id assigned by the subsystem when the channel is registered */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int32 ChannelId = INDEX_NONE;
+
+	/** Unique channel name */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat")
+	FName ChannelName;
+
+	/** Who may join and post */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat")
+	EChatChannelPolicy Policy = EChatChannelPolicy::Open;
+
+	/** Display color for messages in this channel */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat")
+	FLinearColor Color = FLinearColor::White;
+};
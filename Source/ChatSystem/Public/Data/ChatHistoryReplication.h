@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "Data/ChatMessage.h"
+#include "ChatHistoryReplication.generated.h"
+
+class UChatComponent;
+struct FChatHistoryArray;
+
+/**
+ * A single history message replicated to a late joiner
+ */
+USTRUCT()
+struct CHATSYSTEM_API FChatHistoryItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	/**
+	 * The historical message, with its SequenceId
+	 * Its encoding depends on the receiving connection (SenderName is dropped once the Sender is acked), which is
+	 * safe under WithNetSharedSerialization only because the array is COND_OwnerOnly: each component's history is
+	 * serialized for, and read by, its owner's connection alone
+	 */
+	UPROPERTY()
+	FChatMessage Message;
+
+	/** Hands the message to the owning component on the client */
+	void PostReplicatedAdd(const FChatHistoryArray& InArraySerializer);
+};
+
+/**
+ * Message history delta-replicated to the owning client of a ChatComponent
+ * The server appends a few entries per tick, so a late joiner's backlog is spread over several net updates
+ * instead of arriving as a burst of reliable RPCs
+ */
+USTRUCT()
+struct CHATSYSTEM_API FChatHistoryArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	/** Replicated history entries, oldest first */
+	UPROPERTY()
+	TArray<FChatHistoryItem> Items;
+
+	/** Component that owns this array (not replicated, set locally on both ends) */
+	UPROPERTY(NotReplicated)
+	TObjectPtr<UChatComponent> Owner;
+
+	/**
+	 * Append a history entry (server only)
+	 * @param Message The message to replicate
+	 */
+	void AddEntry(const FChatMessage& Message);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FChatHistoryItem, FChatHistoryArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FChatHistoryArray> : public TStructOpsTypeTraitsBase2<FChatHistoryArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
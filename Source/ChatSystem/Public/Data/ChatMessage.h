@@ -20,6 +20,58 @@ enum class EChatChannel : uint8
 	Custom UMETA(DisplayName = "Custom")
 };
 
+/** Number of EChatChannel values, for per-channel lookup tables */
+constexpr int32 NumChatChannels = static_cast<int32>(EChatChannel::Custom) + 1;
+
+/**
+ * Why a chat message was rejected
+ * Sent over the wire as-is and only turned into text where it is displayed
+ */
+UENUM(BlueprintType)
+enum class EChatRejectReason : uint8
+{
+	None UMETA(DisplayName = "None"),
+	NotServer UMETA(DisplayName = "Not Server"),
+	SubsystemUnavailable UMETA(DisplayName = "Subsystem Unavailable"),
+	InvalidSender UMETA(DisplayName = "Invalid Sender"),
+	EmptyMessage UMETA(DisplayName = "Empty Message"),
+	MessageTooLong UMETA(DisplayName = "Message Too Long"),
+	MissingWhisperTarget UMETA(DisplayName = "Missing Whisper Target"),
+	RateLimited UMETA(DisplayName = "Rate Limited"),
+	ProfanityDetected UMETA(DisplayName = "Profanity Detected"),
+	NotOnTeam UMETA(DisplayName = "Not On Team"),
+	UnknownChannel UMETA(DisplayName = "Unknown Channel"),
+	NotChannelMember UMETA(DisplayName = "Not Channel Member")
+};
+
+/**
+ * What the profanity filter does with a matching message
+ */
+UENUM(BlueprintType)
+enum class EChatProfanityFilterMode : uint8
+{
+	/** Replace matched words with asterisks and deliver the message */
+	Mask UMETA(DisplayName = "Mask"),
+	/** Reject the message */
+	Reject UMETA(DisplayName = "Reject"),
+	/** Deliver the message unchanged but raise OnChatMessageFlagged for moderation */
+	Flag UMETA(DisplayName = "Flag")
+};
+
+/**
+ * How messages on a channel are sent to clients
+ */
+UENUM(BlueprintType)
+enum class EChatDeliveryPolicy : uint8
+{
+	/** Reliable RPC: always arrives and in order, but a burst can fill the reliable buffer and delay everything behind it */
+	Reliable UMETA(DisplayName = "Reliable"),
+	/** Unreliable RPC: never holds up other traffic, but is lost with its packet */
+	Unreliable UMETA(DisplayName = "Unreliable"),
+	/** Unreliable RPC, sent again with the next flush; clients drop the second copy if the first arrived */
+	UnreliableRedundant UMETA(DisplayName = "Unreliable With Redundancy")
+};
+
 /**
  * Structure representing a single chat message
  * Designed to be lightweight for replication
@@ -57,6 +109,21 @@ struct CHATSYSTEM_API FChatMessage
 	UPROPERTY(BlueprintReadOnly, Category = "Chat")
 	TObjectPtr<APlayerState> WhisperTarget;
 
+	/** For Custom messages, the registered channel id (INDEX_NONE = unregistered, sent to everyone) */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int32 CustomChannelId;
+
+	/**
+	 * Server only, not replicated: send SenderName even if the receiver knows the Sender
+	 * Set for a short time after a rename, while clients may still have the old replicated PlayerName,
+	 * and on every relayed message so its encoding doesn't depend on the receiving connection
+	 */
+	bool bForceSenderName = false;
+
+	/** Server-assigned id, increasing in routing order (0 = not routed yet); use this rather than Timestamp to order messages */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 SequenceId;
+
 	/** Default constructor */
 	FChatMessage()
 		: Sender(nullptr)
@@ -66,21 +133,28 @@ struct CHATSYSTEM_API FChatMessage
 		, Timestamp(FDateTime::Now())
 		, MessageColor(FLinearColor::White)
 		, WhisperTarget(nullptr)
+		, CustomChannelId(INDEX_NONE)
+		, SequenceId(0)
 	{
 	}
 
 	/** Convenience constructor for common cases */
 	FChatMessage(APlayerState* InSender, const FString& InContent, EChatChannel InChannel)
 		: Sender(InSender)
-		, SenderName(InSender ? InSender->GetPlayerName() : TEXT("System"))
+		, SenderName(InSender ? InSender->GetPlayerName() : SystemSenderName)
 		, Content(InContent)
 		, Channel(InChannel)
 		, Timestamp(FDateTime::Now())
 		, MessageColor(FLinearColor::White)
 		, WhisperTarget(nullptr)
+		, CustomChannelId(INDEX_NONE)
+		, SequenceId(0)
 	{
 	}
 
+	/** SenderName of messages without a player sender */
+	static constexpr const TCHAR* SystemSenderName = TEXT("System");
+
 	/** Check if this is a valid message */
 	bool IsValid() const
 	{
@@ -96,10 +170,14 @@ struct CHATSYSTEM_API FChatMessage
 	/** Get display color based on channel */
 	FLinearColor GetChannelColor() const
 	{
-		switch (Channel)
+		return Channel == EChatChannel::Custom ? MessageColor : GetDefaultChannelColor(Channel);
+	}
+
+	/** Get the built-in display color for a channel (white for Custom) */
+	static FLinearColor GetDefaultChannelColor(EChatChannel InChannel)
+	{
+		switch (InChannel)
 		{
-		case EChatChannel::Global:
-			return FLinearColor::White;
 		case EChatChannel::Team:
 			return FLinearColor(0.0f, 0.8f, 1.0f); // Cyan
 		case EChatChannel::Whisper:
@@ -109,9 +187,49 @@ struct CHATSYSTEM_API FChatMessage
 		case EChatChannel::Proximity:
 			return FLinearColor(0.5f, 1.0f, 0.5f); // Light green
 		default:
-			return MessageColor;
+			return FLinearColor::White;
 		}
 	}
+
+	/**
+	 * Compact network serialization
+	 * The channel is bit-packed, MessageColor is omitted when it matches a default (otherwise sent as RGBA8),
+	 * the timestamp is sent as the message age in milliseconds, and SenderName is dropped when the
+	 * receiving connection already knows the Sender PlayerState (the Sender's NetGUID acts as a compact,
+	 * per-connection sender id and the name comes from its replicated PlayerName) or it is SystemSenderName
+	 * With bForceSenderName set the package map is never consulted, so the bits are the same for every
+	 * connection and the engine can share them across a multicast (WithNetSharedSerialization)
+	 * Anywhere else a message is serialized (client RPCs, the owner-only replicated history) must reach a single
+	 * connection, or set bForceSenderName as the relay does
+	 */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FChatMessage> : public TStructOpsTypeTraitsBase2<FChatMessage>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithNetSharedSerialization = true
+	};
+};
+
+/**
+ * Token bucket parameters for message rate limiting
+ */
+USTRUCT(BlueprintType)
+struct CHATSYSTEM_API FChatRateLimit
+{
+	GENERATED_BODY()
+
+	/** Sustained messages per second (token refill rate) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings", meta = (ClampMin = "0.01"))
+	float MessagesPerSecond = 2.0f;
+
+	/** Messages that may be sent back-to-back before the sustained rate applies (bucket size) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings", meta = (ClampMin = "1"))
+	int32 Burst = 3;
 };
 
 /**
@@ -126,23 +244,177 @@ struct CHATSYSTEM_API FChatSettings
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings")
 	int32 MaxMessageLength = 256;
 
-	/** Minimum time between messages (seconds) */
+	/** Per-player send rate limit (token bucket) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings")
+	FChatRateLimit RateLimit;
+
+	/** Optional per-channel rate limits; a channel listed here uses its own bucket instead of RateLimit */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings")
-	float MessageCooldown = 0.5f;
+	TMap<EChatChannel, FChatRateLimit> ChannelRateLimits;
+
+	/** Per-channel delivery policy; channels not listed here are sent reliably */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|Delivery")
+	TMap<EChatChannel, EChatDeliveryPolicy> ChannelDeliveryPolicies;
+
+	/**
+	 * Hold reliable chat back from a recipient once its PlayerState channel has this many unacknowledged
+	 * reliable bunches, since the engine disconnects at RELIABLE_BUFFER (256). 0 = never hold back
+	 * Ignored under Iris, which has no actor channels to inspect
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|Delivery", meta = (ClampMin = "0", ClampMax = "255"))
+	int32 ReliableBufferThreshold = 192;
+
+	/** Reliable messages held back per recipient; older ones are dropped and reported as a single "N messages skipped" line */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|Delivery", meta = (ClampMin = "1"))
+	int32 MaxReliableBacklog = 100;
+
+	/**
+	 * Send Global and System messages as one multicast on a shared relay actor instead of a client RPC per
+	 * player, so each message is serialized once (always with its SenderName). Relayed messages skip batching, the outbound budget,
+	 * reliable buffer protection and server-side mutes (clients still drop muted senders).
+	 * On Iris servers team messages also go through a relay per team, filtered to the team's connections.
+	 * Not used while bEnableOutboundBudget is set
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|Delivery")
+	bool bUseBroadcastRelay = false;
 
 	/** Maximum messages to keep in history */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings")
 	int32 MaxHistorySize = 100;
 
+	/** Replicate retained history to late joining clients through their ChatComponent */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|History")
+	bool bSyncHistoryToLateJoiners = true;
+
+	/** Maximum history messages handed to each late joiner's replicated history per tick */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|History", meta = (ClampMin = "1", EditCondition = "bSyncHistoryToLateJoiners"))
+	int32 HistorySyncMessagesPerTick = 8;
+
+	/** Append every routed message to an on-disk journal and restore history from it when the server starts */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|History")
+	bool bEnableJournal = false;
+
+	/** Journal file, relative to the project's Saved directory */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|History", meta = (EditCondition = "bEnableJournal"))
+	FString JournalPath = TEXT("Chat/ChatJournal.chatlog");
+
+	/** Seconds between journal writes on the background thread */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|History", meta = (ClampMin = "0.01", EditCondition = "bEnableJournal"))
+	float JournalFlushInterval = 1.0f;
+
+	/** Journal segment size in MB at which it is rotated into a read-only archive, 0 to never rotate */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|History", meta = (ClampMin = "0", EditCondition = "bEnableJournal"))
+	int32 JournalSegmentSizeMB = 64;
+
 	/** Enable profanity filter */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings")
 	bool bEnableProfanityFilter = false;
 
+	/** What to do with messages that match the profanity word list */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings", meta = (EditCondition = "bEnableProfanityFilter"))
+	EChatProfanityFilterMode ProfanityFilterMode = EChatProfanityFilterMode::Mask;
+
+	/** Word list file, one word per line, relative to the project directory */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings", meta = (EditCondition = "bEnableProfanityFilter"))
+	FString ProfanityWordListPath = TEXT("Config/ChatProfanityWords.txt");
+
+	/** Run moderation on worker threads when a stage asks for it, instead of inline on the game thread (BroadcastMessage always runs inline) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings")
+	bool bAsyncModeration = true;
+
 	/** Proximity chat radius (in cm) */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings")
 	float ProximityChatRadius = 1000.0f;
 
+	/** Use a spatial hash grid for proximity recipient lookup instead of checking every player */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings")
+	bool bUseProximityGrid = true;
+
+	/** Seconds between proximity grid rebuilds from pawn positions (0 = at most once per frame) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings", meta = (ClampMin = "0.0", EditCondition = "bUseProximityGrid"))
+	float ProximityGridRefreshInterval = 0.0f;
+
+	/** Seconds after a player renames during which their messages still carry the name explicitly */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings", meta = (ClampMin = "0.0"))
+	float SenderNameResendWindow = 5.0f;
+
 	/** Allow empty messages */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings")
 	bool bAllowEmptyMessages = false;
+
+	/** Queue outgoing messages per recipient and deliver them as a single batched RPC */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|Batching")
+	bool bEnableMessageBatching = false;
+
+	/** Seconds between batch flushes (0 = flush every tick) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|Batching", meta = (ClampMin = "0.0", EditCondition = "bEnableMessageBatching"))
+	float BatchFlushInterval = 0.0f;
+
+	/** Flush a recipient's batch early once it holds this many messages */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|Batching", meta = (ClampMin = "1", EditCondition = "bEnableMessageBatching"))
+	int32 MaxBatchSize = 32;
+
+	/** Flush a recipient's batch early once its estimated payload exceeds this many bytes */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|Batching", meta = (ClampMin = "64", EditCondition = "bEnableMessageBatching"))
+	int32 MaxBatchBytes = 1024;
+
+	/** Queue outgoing messages per recipient and send them highest priority first within OutboundBytesPerSecond */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|Bandwidth")
+	bool bEnableOutboundBudget = false;
+
+	/** Estimated chat bytes per second each recipient may be sent (0 = unlimited, only priority and expiry apply) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|Bandwidth", meta = (ClampMin = "0", EditCondition = "bEnableOutboundBudget"))
+	int32 OutboundBytesPerSecond = 2048;
+
+	/** Seconds a queued message may wait before it is dropped instead of sent late; channels not listed never expire */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chat Settings|Bandwidth", meta = (EditCondition = "bEnableOutboundBudget"))
+	TMap<EChatChannel, float> OutboundMessageLifetimes = {{EChatChannel::Proximity, 2.0f}, {EChatChannel::Global, 5.0f}};
+
+	/** Delivery policy for a channel, Reliable unless ChannelDeliveryPolicies says otherwise */
+	EChatDeliveryPolicy GetDeliveryPolicy(EChatChannel Channel) const
+	{
+		const EChatDeliveryPolicy* Policy = ChannelDeliveryPolicies.Find(Channel);
+		return Policy ? *Policy : EChatDeliveryPolicy::Reliable;
+	}
+};
+
+/**
+ * Counters describing how much the batched delivery path is saving
+ */
+USTRUCT(BlueprintType)
+struct CHATSYSTEM_API FChatBatchingStats
+{
+	GENERATED_BODY()
+
+	/** Messages that went through a per-recipient batch */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 MessagesBatched = 0;
+
+	/** Client RPCs actually issued to flush those batches */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 RPCsSent = 0;
+
+	/** Client RPCs avoided compared to one RPC per message */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 RPCsSaved = 0;
+
+	/** Unreliable client RPCs issued, batched or not */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 UnreliableRPCsSent = 0;
+
+	/** Second copies sent for UnreliableRedundant channels */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 RedundantCopiesSent = 0;
+
+	/** Multicasts issued through the broadcast relay, each reaching every client */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 RelayMulticastsSent = 0;
+
+	/** Reliable messages held back because the recipient's reliable buffer was near full */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 ReliableMessagesDeferred = 0;
+
+	/** Held back messages dropped once a recipient's backlog was full */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 ReliableMessagesSkipped = 0;
 };
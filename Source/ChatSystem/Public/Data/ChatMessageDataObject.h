@@ -20,7 +20,13 @@ class CHATSYSTEM_API UChatMessageDataObject : public UObject
 public:
 	UFUNCTION(BlueprintCallable, Category="Default")
 	FChatMessage GetChatMessage() const;
+
+	/** Access the wrapped message without copying it */
+	const FChatMessage& GetChatMessageRef() const { return ChatMessage; }
 	
 	UFUNCTION(BlueprintCallable, Category="Default")
 	void SetChatMessage(const FChatMessage& Message);
+
+	/** Drop object references held by the wrapped message, called when the object goes back to a pool */
+	void ReleaseChatMessage();
 };
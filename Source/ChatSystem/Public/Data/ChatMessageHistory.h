@@ -0,0 +1,102 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/ChatMessage.h"
+#include "ChatMessageHistory.generated.h"
+
+/**
+ * Fixed-capacity circular buffer of chat messages
+ * Once full, new messages overwrite the oldest entry in place instead of shifting the array
+ * Logical index 0 is always the oldest retained message
+ * Messages are expected to be added in SequenceId order with consecutive ids, so lookup by id is O(1)
+ */
+USTRUCT()
+struct CHATSYSTEM_API FChatMessageHistory
+{
+	GENERATED_BODY()
+
+	/**
+	 * Change the capacity, keeping the newest messages that still fit
+	 * @param NewCapacity Maximum number of messages to retain (0 = keep nothing)
+	 */
+	void SetCapacity(int32 NewCapacity);
+
+	/** Maximum number of messages retained */
+	int32 GetCapacity() const { return Capacity; }
+
+	/** Number of messages currently retained */
+	int32 Num() const { return Storage.Num(); }
+
+	/** True if no messages are retained */
+	bool IsEmpty() const { return Storage.Num() == 0; }
+
+	/**
+	 * Append a message, overwriting the oldest one if the buffer is full
+	 * @param Message The message to add
+	 */
+	void Add(const FChatMessage& Message);
+	void Add(FChatMessage&& Message);
+
+	/**
+	 * Access a message by logical position
+	 * @param Index 0 for the oldest message, Num() - 1 for the newest
+	 */
+	const FChatMessage& operator[](int32 Index) const
+	{
+		check(Index >= 0 && Index < Storage.Num());
+		return Storage[ToStorageIndex(Index)];
+	}
+
+	/** SequenceId of the oldest retained message (0 when empty) */
+	int64 GetFirstSequence() const { return Storage.Num() > 0 ? (*this)[0].SequenceId : 0; }
+
+	/**
+	 * Find a retained message by sequence id
+	 * @param Sequence The id to look up
+	 * @return The message, or nullptr if it was evicted or never added
+	 */
+	const FChatMessage* FindBySequence(int64 Sequence) const
+	{
+		const int64 Index = Sequence - GetFirstSequence();
+		if (Storage.Num() == 0 || Index < 0 || Index >= Storage.Num())
+		{
+			return nullptr;
+		}
+
+		const FChatMessage& Message = (*this)[static_cast<int32>(Index)];
+		return Message.SequenceId == Sequence ? &Message : nullptr;
+	}
+
+	/** Get the newest message (buffer must not be empty) */
+	const FChatMessage& Last() const { return (*this)[Storage.Num() - 1]; }
+
+	/**
+	 * Copy the newest messages, oldest first
+	 * @param Count Number of messages to copy (0 or less = all)
+	 * @param OutMessages Receives the messages
+	 */
+	void GetLast(int32 Count, TArray<FChatMessage>& OutMessages) const;
+
+	/** Remove all messages, keeping the capacity */
+	void Empty();
+
+private:
+	/** Map a logical index onto the underlying storage */
+	int32 ToStorageIndex(int32 Index) const
+	{
+		const int32 StorageIndex = Head + Index;
+		return StorageIndex < Storage.Num() ? StorageIndex : StorageIndex - Storage.Num();
+	}
+
+	/** Backing storage, grows up to Capacity and then wraps */
+	UPROPERTY()
+	TArray<FChatMessage> Storage;
+
+	/** Storage index of the oldest message once the buffer has wrapped */
+	int32 Head = 0;
+
+	/** Maximum number of messages retained */
+	int32 Capacity = 0;
+};
@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/ChatMessage.h"
+#include "ChatMessageObjectPool.generated.h"
+
+class UChatMessageDataObject;
+
+/**
+ * Counters for the client-side message object pool
+ */
+USTRUCT(BlueprintType)
+struct CHATSYSTEM_API FChatMessagePoolStats
+{
+	GENERATED_BODY()
+
+	/** Messages wrapped in a recycled object */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 Hits = 0;
+
+	/** Messages that needed a new object */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 Misses = 0;
+
+	/** Objects currently in the retained window */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int32 NumRetained = 0;
+
+	/** Objects waiting to be reused */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int32 NumFree = 0;
+};
+
+/**
+ * Retained window of UChatMessageDataObjects for ListView entries, oldest first
+ * Objects that scroll out of the window are kept and rewrapped around later messages
+ * instead of being left for the garbage collector
+ */
+USTRUCT()
+struct CHATSYSTEM_API FChatMessageObjectPool
+{
+	GENERATED_BODY()
+
+	/**
+	 * Wrap a message and append it to the retained window
+	 * @param Outer Outer for newly created objects
+	 * @param Message The message to wrap
+	 * @param MaxRetained Window size (at least 1); the oldest objects beyond it are evicted first
+	 * @param OutEvicted Receives the objects that left the window (already back in the pool)
+	 * @return The object wrapping Message
+	 */
+	UChatMessageDataObject* Add(UObject* Outer, const FChatMessage& Message, int32 MaxRetained, TArray<UChatMessageDataObject*>& OutEvicted);
+
+	/**
+	 * Shrink the retained window
+	 * @param MaxRetained New window size
+	 * @param OutEvicted Receives the objects that left the window
+	 */
+	void Trim(int32 MaxRetained, TArray<UChatMessageDataObject*>& OutEvicted);
+
+	/** Retained objects, oldest first */
+	const TArray<TObjectPtr<UChatMessageDataObject>>& GetRetained() const { return Retained; }
+
+	/** Get pool counters */
+	FChatMessagePoolStats GetStats() const;
+
+	/** Drop every object, retained or free */
+	void Empty();
+
+private:
+	/** Move the oldest retained object to the free list */
+	UChatMessageDataObject* EvictOldest();
+
+	/** Objects in the retained window, oldest first (window is small, so removing the front is cheap) */
+	UPROPERTY()
+	TArray<TObjectPtr<UChatMessageDataObject>> Retained;
+
+	/** Evicted objects ready for reuse */
+	UPROPERTY()
+	TArray<TObjectPtr<UChatMessageDataObject>> Free;
+
+	int64 Hits = 0;
+	int64 Misses = 0;
+};
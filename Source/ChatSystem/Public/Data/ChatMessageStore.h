@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/ChatMessage.h"
+#include "Data/ChatMessageHistory.h"
+#include "ChatMessageStore.generated.h"
+
+/**
+ * What changed in one channel of a message store since the last notification
+ * Indices are absolute: a message keeps its index for as long as it is retained
+ */
+USTRUCT(BlueprintType)
+struct CHATSYSTEM_API FChatStoreChange
+{
+	GENERATED_BODY()
+
+	/** The channel that changed */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	EChatChannel Channel = EChatChannel::Global;
+
+	/** Absolute index of the first appended message */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 FirstAppended = 0;
+
+	/** Number of messages appended (all still retained) */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int32 NumAppended = 0;
+
+	/** Absolute index of the first evicted message */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 FirstEvicted = 0;
+
+	/** Number of messages evicted from the front */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int32 NumEvicted = 0;
+};
+
+/**
+ * Bounded store of received messages with one ring buffer per channel
+ * Messages are addressed by absolute index within their channel, so a virtualized list can fetch just
+ * the visible rows and keep its row indices across evictions
+ */
+USTRUCT()
+struct CHATSYSTEM_API FChatMessageStore
+{
+	GENERATED_BODY()
+
+	FChatMessageStore();
+
+	/**
+	 * Change the per-channel capacity, keeping the newest messages
+	 * @param NewCapacity Maximum messages retained per channel
+	 */
+	void SetCapacity(int32 NewCapacity);
+
+	/** Maximum messages retained per channel */
+	int32 GetCapacity() const { return Capacity; }
+
+	/**
+	 * Append a message to its channel, evicting that channel's oldest message if it is full
+	 * @param Message The message to store
+	 */
+	void Add(const FChatMessage& Message);
+
+	/** Absolute index of a channel's oldest retained message */
+	int64 GetFirstIndex(EChatChannel Channel) const { return GetEndIndex(Channel) - Channels[static_cast<int32>(Channel)].Num(); }
+
+	/** Absolute index one past a channel's newest message */
+	int64 GetEndIndex(EChatChannel Channel) const { return NumAdded[static_cast<int32>(Channel)]; }
+
+	/**
+	 * Get a retained message by absolute index
+	 * @param Channel The channel
+	 * @param Index Absolute index within the channel
+	 * @return The message, or nullptr if it was evicted or does not exist yet
+	 */
+	const FChatMessage* Find(EChatChannel Channel, int64 Index) const;
+
+	/**
+	 * Copy a range of retained messages, skipping indices that are no longer (or not yet) retained
+	 * @param Channel The channel
+	 * @param FirstIndex Absolute index of the first message
+	 * @param Count Number of messages
+	 * @param OutMessages Receives the messages, oldest first
+	 */
+	void GetRange(EChatChannel Channel, int64 FirstIndex, int32 Count, TArray<FChatMessage>& OutMessages) const;
+
+	/**
+	 * Collect what changed since the last call, one entry per changed channel
+	 * @param OutChanges Receives the changes
+	 */
+	void ConsumeChanges(TArray<FChatStoreChange>& OutChanges);
+
+	/** Remove all messages, keeping absolute indices increasing */
+	void Empty();
+
+private:
+	/** One ring buffer per EChatChannel */
+	UPROPERTY()
+	TArray<FChatMessageHistory> Channels;
+
+	/** Messages ever added per channel, the end of each channel's absolute index range */
+	int64 NumAdded[NumChatChannels] = {};
+
+	/** First and end index of each channel at the last ConsumeChanges */
+	int64 NotifiedFirst[NumChatChannels] = {};
+	int64 NotifiedEnd[NumChatChannels] = {};
+
+	/** Bit per channel changed since the last ConsumeChanges */
+	uint32 DirtyChannels = 0;
+
+	/** Maximum messages retained per channel */
+	int32 Capacity = 0;
+};
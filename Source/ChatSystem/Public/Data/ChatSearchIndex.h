@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/ChatMessage.h"
+
+/**
+ * Incremental inverted index over a sliding window of chat messages
+ * Maps each case-folded word of a message's content, and its sender name, to the sequence ids of the
+ * messages containing it. Messages must be added in SequenceId order and removed oldest first, which
+ * is how FChatMessageHistory retains them, so every posting list stays sorted and eviction only ever
+ * pops from the front.
+ */
+class CHATSYSTEM_API FChatSearchIndex
+{
+public:
+	/** Query prefix that matches a sender name instead of a word */
+	static constexpr const TCHAR* SenderPrefix = TEXT("from:");
+
+	/**
+	 * Index a message
+	 * @param Message The message, newer than every message already indexed
+	 */
+	void Add(const FChatMessage& Message);
+
+	/**
+	 * Remove a message from the index
+	 * @param Message The message, which must be the oldest one indexed
+	 */
+	void Remove(const FChatMessage& Message);
+
+	/**
+	 * Find messages containing every term of a query
+	 * Terms are separated by whitespace; a term of the form "from:Name" matches the sender name
+	 * Words too long to be indexed can't match anything, so a query containing one finds nothing
+	 * @param Query The search terms
+	 * @param MaxResults Maximum number of matches, newest first
+	 * @param Filter Called with each candidate's sequence id, return false to skip it
+	 * @param OutSequenceIds Receives the newest matches, oldest first
+	 */
+	void Search(const FString& Query, int32 MaxResults, TFunctionRef<bool(int64)> Filter, TArray<int64>& OutSequenceIds) const;
+
+	/** Number of distinct words and sender names indexed */
+	int32 GetNumTerms() const { return Postings.Num(); }
+
+	/** Remove everything */
+	void Empty();
+
+	/**
+	 * Split text into unique, lowercase alphanumeric words
+	 * Words longer than the index keeps are left out
+	 * @param Text The text to split
+	 * @param OutTokens Receives the words (appended)
+	 * @return False if a word was left out for being too long
+	 */
+	static bool Tokenize(const FString& Text, TArray<FString>& OutTokens);
+
+private:
+	/** Sequence ids of the messages containing one term, oldest first */
+	struct FPostingList
+	{
+		TArray<int64> SequenceIds;
+
+		/** Entries before this were evicted and are compacted away lazily */
+		int32 First = 0;
+
+		TConstArrayView<int64> GetLive() const { return MakeArrayView(SequenceIds.GetData() + First, SequenceIds.Num() - First); }
+	};
+
+	/** Terms a message is indexed under: its content words and its sender key */
+	static void GetTerms(const FChatMessage& Message, TArray<FString>& OutTerms);
+
+	/** Key a sender name is indexed under */
+	static FString MakeSenderKey(const FString& SenderName);
+
+	TMap<FString, FPostingList> Postings;
+};
@@ -0,0 +1,128 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/RingBuffer.h"
+
+/**
+ * What a sequence tracker made of an incoming message
+ */
+enum class EChatSequenceResult : uint8
+{
+	/** Newer than anything seen so far */
+	New,
+	/** Older than the newest seen, but not seen before (arrived through a slower path) */
+	Reordered,
+	/** Already seen */
+	Duplicate,
+	/** Older than ids already forgotten, so there is no telling whether it is a duplicate */
+	Stale
+};
+
+/**
+ * Recently seen message sequence ids for one channel
+ * Sequence ids are global to the server, so one client sees a sparse, uneven subset of them on each
+ * channel; a window measured in ids would forget messages that are only a few deliveries old. Instead
+ * every id seen in the last RetentionSeconds is remembered (up to MaxRemembered), which covers redundant
+ * copies and late arrivals over any path for as long as they can plausibly turn up
+ */
+struct FChatSequenceTracker
+{
+	/** Seconds a seen id is remembered */
+	static constexpr double RetentionSeconds = 30.0;
+
+	/** Most ids remembered at once; the oldest are forgotten first */
+	static constexpr int32 MaxRemembered = 1024;
+
+	/**
+	 * Record a sequence id
+	 * @param Sequence The id to record (must be positive)
+	 * @param Now FPlatformTime::Seconds()
+	 * @return Whether the id is new, late, already seen or too old to judge
+	 */
+	EChatSequenceResult Accept(int64 Sequence, double Now)
+	{
+		ForgetExpired(Now);
+
+		if (Sequence > Highest)
+		{
+			Remember(Sequence, Now);
+			Highest = Sequence;
+			return EChatSequenceResult::New;
+		}
+
+		if (Seen.Contains(Sequence))
+		{
+			return EChatSequenceResult::Duplicate;
+		}
+
+		// At or below an id that was already forgotten, so it may have been seen before that
+		if (Sequence <= HighestForgotten)
+		{
+			return EChatSequenceResult::Stale;
+		}
+
+		Remember(Sequence, Now);
+		return EChatSequenceResult::Reordered;
+	}
+
+	/** Highest id seen (0 = none) */
+	int64 GetHighest() const { return Highest; }
+
+	/** Number of ids currently remembered */
+	int32 NumRemembered() const { return Order.Num(); }
+
+	/** Forget everything seen */
+	void Reset()
+	{
+		Highest = 0;
+		HighestForgotten = 0;
+		Seen.Reset();
+		Order.Empty();
+	}
+
+private:
+	struct FEntry
+	{
+		int64 Sequence;
+		double Time;
+	};
+
+	/** Highest id seen */
+	int64 Highest = 0;
+
+	/** Highest id that was remembered and has since been forgotten */
+	int64 HighestForgotten = 0;
+
+	/** Ids remembered, for lookup */
+	TSet<int64> Seen;
+
+	/** The same ids in the order they were seen, oldest first */
+	TRingBuffer<FEntry> Order;
+
+	void Remember(int64 Sequence, double Now)
+	{
+		if (Order.Num() >= MaxRemembered)
+		{
+			ForgetOldest();
+		}
+		Seen.Add(Sequence);
+		Order.Add({ Sequence, Now });
+	}
+
+	void ForgetExpired(double Now)
+	{
+		while (Order.Num() > 0 && Now - Order.First().Time > RetentionSeconds)
+		{
+			ForgetOldest();
+		}
+	}
+
+	void ForgetOldest()
+	{
+		const FEntry Oldest = Order.PopFrontValue();
+		Seen.Remove(Oldest.Sequence);
+		HighestForgotten = FMath::Max(HighestForgotten, Oldest.Sequence);
+	}
+};
@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/ChatMessage.h"
+
+/**
+ * Lazily refilled token bucket
+ * Refill happens on consume, so an idle bucket costs nothing
+ */
+struct FChatTokenBucket
+{
+	/** Tokens currently available */
+	float Tokens = 0.0f;
+
+	/** Time the bucket was last refilled (negative = never used, starts full) */
+	double LastRefillTime = -1.0;
+
+	/**
+	 * Refill for the elapsed time and try to take one token
+	 * @param Now Current time in seconds
+	 * @param Limit The rate and burst to apply
+	 * @return True if a token was available
+	 */
+	bool TryConsume(double Now, const FChatRateLimit& Limit)
+	{
+		const float Burst = static_cast<float>(FMath::Max(1, Limit.Burst));
+		if (LastRefillTime < 0.0)
+		{
+			Tokens = Burst;
+		}
+		else
+		{
+			Tokens = FMath::Min(Burst, Tokens + static_cast<float>(Now - LastRefillTime) * Limit.MessagesPerSecond);
+		}
+		LastRefillTime = Now;
+
+		if (Tokens < 1.0f)
+		{
+			return false;
+		}
+
+		Tokens -= 1.0f;
+		return true;
+	}
+
+	/**
+	 * Check whether the bucket has refilled to its burst, i.e. holds no state worth keeping
+	 * @param Now Current time in seconds
+	 * @param Limit The rate and burst to apply
+	 */
+	bool IsFull(double Now, const FChatRateLimit& Limit) const
+	{
+		if (LastRefillTime < 0.0)
+		{
+			return true;
+		}
+
+		const float Burst = static_cast<float>(FMath::Max(1, Limit.Burst));
+		return Tokens + static_cast<float>(Now - LastRefillTime) * FMath::Max(0.0f, Limit.MessagesPerSecond) >= Burst;
+	}
+};
+
+/**
+ * Rate limiting state for one player: a shared bucket plus one per channel for channel overrides
+ */
+struct FChatRateLimitSlot
+{
+	FChatTokenBucket SharedBucket;
+	FChatTokenBucket ChannelBuckets[NumChatChannels];
+
+	/**
+	 * Try to take a token for a message on a channel
+	 * @param Now Current time in seconds
+	 * @param Channel The channel the message is sent on
+	 * @param Settings Settings holding the default and per-channel limits
+	 * @return True if the message may be sent
+	 */
+	bool TryConsume(double Now, EChatChannel Channel, const FChatSettings& Settings)
+	{
+		if (const FChatRateLimit* ChannelLimit = Settings.ChannelRateLimits.Find(Channel))
+		{
+			return ChannelBuckets[static_cast<int32>(Channel)].TryConsume(Now, *ChannelLimit);
+		}
+
+		return SharedBucket.TryConsume(Now, Settings.RateLimit);
+	}
+
+	/**
+	 * Check whether every bucket in use has refilled, so dropping the slot would not grant any extra messages
+	 * @param Now Current time in seconds
+	 * @param Settings Settings holding the default and per-channel limits
+	 */
+	bool IsFull(double Now, const FChatSettings& Settings) const
+	{
+		if (!SharedBucket.IsFull(Now, Settings.RateLimit))
+		{
+			return false;
+		}
+
+		for (const TPair<EChatChannel, FChatRateLimit>& Pair : Settings.ChannelRateLimits)
+		{
+			if (!ChannelBuckets[static_cast<int32>(Pair.Key)].IsFull(Now, Pair.Value))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+};
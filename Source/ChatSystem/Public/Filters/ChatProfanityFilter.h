@@ -0,0 +1,132 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Moderation/ChatMessageValidator.h"
+
+/**
+ * Multi-pattern word filter backed by an Aho-Corasick automaton
+ * Scans a message once regardless of how many words are in the list
+ * Words only match whole words of the text, so "ass" does not match "class". A leading or trailing * in
+ * the list lets a word match inside longer words ("*word*" anywhere, "word*" at the start of a word).
+ * Text and patterns are case-folded, and inside words that contain a letter the usual digit and symbol
+ * substitutions are undone ("b4d" matches "bad", while "455" stays a number)
+ * Immutable once built, so a single instance can be shared across threads and swapped atomically
+ */
+class CHATSYSTEM_API FChatProfanityFilter
+{
+public:
+	/**
+	 * Build a filter from a list of words
+	 * @param Words The words to match, optionally with a leading or trailing * (empty entries are ignored)
+	 * @return The compiled filter
+	 */
+	static TSharedRef<const FChatProfanityFilter> Build(const TArray<FString>& Words);
+
+	/**
+	 * Build a filter from a word list file (one word per line, lines starting with # are ignored)
+	 * @param FilePath Absolute path to the word list
+	 * @return The compiled filter, or nullptr if the file could not be read
+	 */
+	static TSharedPtr<const FChatProfanityFilter> BuildFromFile(const FString& FilePath);
+
+	/**
+	 * Check whether the text contains any listed word
+	 * @param Text The text to scan
+	 * @return True if at least one word matched
+	 */
+	bool ContainsMatch(const FString& Text) const;
+
+	/**
+	 * Replace every matched character with a mask character
+	 * @param Text The text to mask in place
+	 * @param MaskChar The replacement character
+	 * @return True if anything was masked
+	 */
+	bool Mask(FString& Text, TCHAR MaskChar = TEXT('*')) const;
+
+	/** Number of words compiled into the automaton */
+	int32 GetNumPatterns() const { return NumPatterns; }
+
+	/** Number of automaton states */
+	int32 GetNumStates() const { return Nodes.Num(); }
+
+private:
+	/** A state of the automaton with its outgoing edges stored contiguously in EdgeChars/EdgeTargets */
+	struct FNode
+	{
+		int32 FirstEdge = 0;
+		int32 NumEdges = 0;
+		int32 Fail = 0;
+
+		/** Length of the word ending exactly at this state (0 = none) */
+		int32 MatchLength = 0;
+
+		/** EMatchFlags of that word */
+		uint8 MatchFlags = 0;
+
+		/** Nearest state along the failure links that ends a word (0 = none) */
+		int32 Output = 0;
+	};
+
+	/** Where a word may match besides a whole word of the text */
+	enum EMatchFlags : uint8
+	{
+		AnyStart	= 1 << 0,
+		AnyEnd		= 1 << 1,
+	};
+
+	/** Characters below this use a direct lookup table at the root */
+	static constexpr int32 RootTableSize = 128;
+
+	/** Fold a character for matching, undoing substitutions (only used inside words that contain a letter) */
+	static TCHAR Normalize(TCHAR Char);
+
+	/** Whether the character at Index belongs to a word; substitution symbols only do when a letter or digit follows */
+	static bool IsWordChar(const FString& Text, int32 Index);
+
+	/**
+	 * Call Visitor with the range [Start, End) of every match, in order of End
+	 * @param Visitor Return false to stop scanning
+	 */
+	void ForEachMatch(const FString& Text, TFunctionRef<bool(int32 Start, int32 End)> Visitor) const;
+
+	/** Follow an edge, returning INDEX_NONE if the state has no edge for the character */
+	int32 FindEdge(int32 State, TCHAR Char) const;
+
+	/** Advance the automaton by one (normalized) character, following failure links as needed */
+	int32 Step(int32 State, TCHAR Char) const;
+
+	TArray<FNode> Nodes;
+	TArray<TCHAR> EdgeChars;
+	TArray<int32> EdgeTargets;
+
+	/** Root transitions for ASCII, INDEX_NONE where the root has no edge */
+	int32 RootTable[RootTableSize];
+
+	int32 NumPatterns = 0;
+};
+
+/**
+ * Moderation stage that applies a profanity filter according to a filter mode
+ */
+class CHATSYSTEM_API FChatProfanityValidator : public IChatMessageValidator
+{
+public:
+	FChatProfanityValidator(const TSharedRef<const FChatProfanityFilter>& InFilter, EChatProfanityFilterMode InMode)
+		: Filter(InFilter)
+		, Mode(InMode)
+	{
+	}
+
+	//~ Begin IChatMessageValidator interface
+	virtual EChatRejectReason Validate(FChatModerationContext& Context) const override;
+	virtual FName GetValidatorName() const override { return TEXT("ProfanityFilter"); }
+	virtual bool RunsOffGameThread() const override { return false; }
+	//~ End IChatMessageValidator interface
+
+private:
+	TSharedRef<const FChatProfanityFilter> Filter;
+	EChatProfanityFilterMode Mode;
+};
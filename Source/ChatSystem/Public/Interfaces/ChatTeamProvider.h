@@ -0,0 +1,34 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "ChatTeamProvider.generated.h"
+
+/**
+ * Interface for PlayerStates that belong to a team
+ * Implement on your PlayerState to enable team chat routing
+ */
+UINTERFACE(MinimalAPI, Blueprintable)
+class UChatTeamProvider : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Supplies the team id used to route team chat
+ * Call UChatSubsystem::NotifyTeamChanged on the server whenever the value changes
+ */
+class CHATSYSTEM_API IChatTeamProvider
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Get the team this player belongs to
+	 * @return The team id, or INDEX_NONE if the player is not on a team
+	 */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Chat")
+	int32 GetChatTeamId() const;
+};
@@ -0,0 +1,48 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/ChatMessage.h"
+
+/**
+ * Message being moderated, handed to each validator in turn
+ */
+struct FChatModerationContext
+{
+	/**
+	 * The message under moderation; validators may rewrite Content
+	 * Object pointers are only carried along and must not be dereferenced off the game thread
+	 */
+	FChatMessage Message;
+
+	/** Set by a validator to deliver the message but report it through OnChatMessageFlagged */
+	bool bFlagged = false;
+};
+
+/**
+ * A pluggable moderation check
+ * Validators run on worker threads when asynchronous moderation is enabled, so implementations
+ * must be thread-safe and must not touch UObjects
+ */
+class IChatMessageValidator
+{
+public:
+	virtual ~IChatMessageValidator() = default;
+
+	/**
+	 * Check (and optionally rewrite) a message
+	 * @param Context The message being moderated
+	 * @return EChatRejectReason::None to let the message through, otherwise why it is rejected
+	 */
+	virtual EChatRejectReason Validate(FChatModerationContext& Context) const = 0;
+
+	/** Name used in logs and moderation stats */
+	virtual FName GetValidatorName() const = 0;
+
+	/**
+	 * True if this stage is too expensive for the game thread
+	 * Chains made only of cheap stages are run inline even when asynchronous moderation is enabled
+	 */
+	virtual bool RunsOffGameThread() const { return true; }
+};
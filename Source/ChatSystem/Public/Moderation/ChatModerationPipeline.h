@@ -0,0 +1,154 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Moderation/ChatMessageValidator.h"
+#include <atomic>
+#include "ChatModerationPipeline.generated.h"
+
+class APlayerState;
+
+/**
+ * Queue depth, pipeline latency and per-validator timing of the moderation pipeline
+ */
+USTRUCT(BlueprintType)
+struct CHATSYSTEM_API FChatModerationStats
+{
+	GENERATED_BODY()
+
+	/** Messages enqueued but not yet released to routing */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int32 QueueDepth = 0;
+
+	/** Messages that finished moderation */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 MessagesProcessed = 0;
+
+	/** Messages rejected by a validator */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 MessagesRejected = 0;
+
+	/** Average time from enqueue until a worker picked the message up (ms) */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	float AverageQueueWaitMs = 0.0f;
+
+	/** Average time spent running validators (ms) */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	float AverageValidationMs = 0.0f;
+
+	/** Average time from validation finishing until release on the game thread, including ordering holds (ms) */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	float AverageReleaseWaitMs = 0.0f;
+
+	/** Longest time spent running validators for a single message (ms) */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	float MaxValidationMs = 0.0f;
+
+	/** Average time spent in each validator, by validator name, over the messages that reached it (ms) */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	TMap<FName, float> AverageStageMs;
+};
+
+/** Validators snapshot shared by in-flight jobs; replaced as a whole when validators change */
+using FChatValidatorList = TArray<TSharedRef<const IChatMessageValidator>>;
+
+/**
+ * A message moving through the moderation pipeline
+ */
+struct FChatModerationJob
+{
+	FChatModerationContext Context;
+
+	/** Weak copies of the message's object pointers, re-checked before the message is routed */
+	TWeakObjectPtr<APlayerState> Sender;
+	TWeakObjectPtr<APlayerState> WhisperTarget;
+
+	/** Validators to run, captured at enqueue time */
+	TSharedPtr<const FChatValidatorList> Validators;
+
+	/** Outcome of the validators */
+	EChatRejectReason Result = EChatRejectReason::None;
+
+	/** Stage timestamps (FPlatformTime::Seconds) */
+	double EnqueueTime = 0.0;
+	double StartTime = 0.0;
+	double FinishTime = 0.0;
+
+	/** Time spent in each validator that ran, in chain order (seconds) */
+	TArray<double, TInlineAllocator<4>> StageSeconds;
+
+	/** Set by the worker once Result and the timestamps are final */
+	std::atomic<bool> bComplete { false };
+
+	/** Run the validators in order, stopping at the first rejection */
+	void Run();
+};
+
+/**
+ * Runs message validators on worker threads and hands results back to the game thread
+ * Messages from the same sender are released in the order they were enqueued, even if
+ * later ones finish validation first
+ * Enqueue and ReleaseCompleted must be called from the game thread
+ */
+class CHATSYSTEM_API FChatModerationPipeline
+{
+public:
+	/**
+	 * Start moderating a message on a worker thread
+	 * @param Message The message to moderate
+	 * @param SenderKey Key that defines the ordering domain (messages with the same key stay in order)
+	 * @param Validators The validators to run
+	 */
+	void Enqueue(const FChatMessage& Message, int32 SenderKey, const TSharedPtr<const FChatValidatorList>& Validators);
+
+	/**
+	 * Moderate a message inline on the calling thread
+	 * @param Job The job to run; its Context must already hold the message
+	 */
+	void RunSynchronously(FChatModerationJob& Job);
+
+	/**
+	 * Release finished jobs, in per-sender order
+	 * @param Callback Called on the game thread with each finished job
+	 */
+	void ReleaseCompleted(TFunctionRef<void(FChatModerationJob&)> Callback);
+
+	/** Wait for every in-flight job and release them all */
+	void Flush(TFunctionRef<void(FChatModerationJob&)> Callback);
+
+	/** Drop every queued job without releasing it */
+	void Reset();
+
+	/** True if any job is queued or in flight */
+	bool HasPendingWork() const { return QueueDepth > 0; }
+
+	/** True if a job with this sender key is queued or in flight */
+	bool HasPendingWork(int32 SenderKey) const { return PendingBySender.Contains(SenderKey); }
+
+	/** Current queue depth and latency stats */
+	FChatModerationStats GetStats() const;
+
+private:
+	/** Fold a finished job's timings into the stats */
+	void RecordCompletion(const FChatModerationJob& Job, double ReleaseTime);
+
+	/** Jobs per sender key, oldest first */
+	TMap<int32, TArray<TSharedRef<FChatModerationJob>>> PendingBySender;
+
+	/** Jobs queued or in flight */
+	int32 QueueDepth = 0;
+
+	FChatModerationStats Stats;
+	double TotalQueueWaitSeconds = 0.0;
+	double TotalValidationSeconds = 0.0;
+	double TotalReleaseWaitSeconds = 0.0;
+
+	/** Accumulated time and message count per validator name */
+	struct FStageTotals
+	{
+		double Seconds = 0.0;
+		int64 NumMessages = 0;
+	};
+	TMap<FName, FStageTotals> StageTotals;
+};
@@ -0,0 +1,131 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/ChatMessage.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Read-only archive of a rotated chat journal segment
+ *
+ * Archives are memory-mapped rather than read, so querying a large archive only touches the pages
+ * holding the index and the matching records. Every IndexInterval records the archive stores a sparse
+ * index entry, which lets sequence and time range queries binary search to the right block instead
+ * of scanning the whole file.
+ *
+ * Layout: header, records in journal format, padding to 8 bytes, then the sparse index.
+ */
+class CHATSYSTEM_API FChatArchive
+{
+public:
+	/** Records between two sparse index entries */
+	static constexpr int64 IndexInterval = 64;
+
+	/** File extension of archives, next to the journal they were rotated from */
+	static constexpr const TCHAR* Extension = TEXT(".chatarc");
+
+	/**
+	 * Write an archive from a block of journal records
+	 * The file is written under a temporary name and renamed, so a partial archive is never visible
+	 * @param ArchivePath Archive file to create
+	 * @param Records Journal records, without the journal header; a torn tail is dropped
+	 * @return True if the archive was written
+	 */
+	static bool Write(const FString& ArchivePath, TConstArrayView<uint8> Records);
+
+	/**
+	 * Map an archive for reading
+	 * @param ArchivePath Archive file to open
+	 * @return The archive, or nullptr if it could not be mapped or is not a valid archive
+	 */
+	static TUniquePtr<FChatArchive> Open(const FString& ArchivePath);
+
+	/**
+	 * Name for the archive of a segment, sorting by the segment's first sequence id
+	 * @param JournalPath Path of the live journal
+	 * @param FirstSequenceId Sequence id of the segment's first record
+	 */
+	static FString MakeArchivePath(const FString& JournalPath, int64 FirstSequenceId);
+
+	/**
+	 * Find the archives rotated from a journal
+	 * @param JournalPath Path of the live journal
+	 * @param OutArchivePaths Receives the archive paths, oldest first
+	 */
+	static void FindArchives(const FString& JournalPath, TArray<FString>& OutArchivePaths);
+
+	~FChatArchive();
+
+	int64 GetNumRecords() const { return Header.NumRecords; }
+	int64 GetFirstSequenceId() const { return Header.FirstSequenceId; }
+	int64 GetLastSequenceId() const { return Header.LastSequenceId; }
+
+	/** Earliest and latest timestamp in the archive; timestamps are not guaranteed to be in order */
+	FDateTime GetMinTimestamp() const { return FDateTime(Header.MinTicks); }
+	FDateTime GetMaxTimestamp() const { return FDateTime(Header.MaxTicks); }
+
+	/**
+	 * Get the messages in a sequence id range
+	 * @param FirstSequenceId First sequence id, inclusive
+	 * @param LastSequenceId Last sequence id, inclusive
+	 * @param MaxResults Stop after this many messages
+	 * @param OutMessages Messages are appended in sequence order (Sender is always null)
+	 */
+	void QueryBySequence(int64 FirstSequenceId, int64 LastSequenceId, int32 MaxResults, TArray<FChatMessage>& OutMessages) const;
+
+	/**
+	 * Get the messages timestamped within a time range
+	 * @param From Start of the range, inclusive
+	 * @param To End of the range, exclusive
+	 * @param MaxResults Stop after this many messages
+	 * @param OutMessages Messages are appended in sequence order (Sender is always null)
+	 */
+	void QueryByTime(const FDateTime& From, const FDateTime& To, int32 MaxResults, TArray<FChatMessage>& OutMessages) const;
+
+private:
+	struct FHeader
+	{
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		int64 NumRecords = 0;
+		int64 FirstSequenceId = 0;
+		int64 LastSequenceId = 0;
+		int64 MinTicks = 0;
+		int64 MaxTicks = 0;
+		int64 IndexOffset = 0;
+		int64 NumIndexEntries = 0;
+	};
+
+	/**
+	 * One sparse index entry, at the start of a block of IndexInterval records
+	 * Timestamps can go backwards (e.g. a clock adjustment), so each entry carries the newest timestamp
+	 * up to the end of its block and the oldest from its start onwards; both are monotonic and can be
+	 * binary searched
+	 */
+	struct FIndexEntry
+	{
+		int64 SequenceId = 0;
+		int64 Offset = 0;
+		int64 MaxTicksThroughBlock = 0;
+		int64 MinTicksFromBlock = 0;
+	};
+
+	FChatArchive() = default;
+
+	/** Records in one index block */
+	TConstArrayView<uint8> GetBlockRecords(int32 Block) const;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	FHeader Header;
+
+	/** Index entries, pointing into the mapped file */
+	TConstArrayView<FIndexEntry> Index;
+
+	/** Start of the mapped file */
+	const uint8* Data = nullptr;
+};
@@ -0,0 +1,96 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include "Data/ChatMessage.h"
+#include <atomic>
+
+class IFileHandle;
+class FRunnableThread;
+class FEvent;
+
+/**
+ * Append-only on-disk log of routed chat messages
+ *
+ * The game thread only encodes each message into a small binary record and queues it; a background
+ * thread writes queued records in batches and flushes once per batch. Every CheckpointInterval
+ * records the writer also appends (record number, file offset) to a sidecar index, so reopening
+ * the journal only has to read the tail of the log to rebuild recent history.
+ *
+ * Log layout: header (magic, version), then records of [payload size][payload CRC][payload].
+ * A torn record at the end (e.g. after a crash) is detected by its size or CRC and cut off on open.
+ *
+ * Once the log grows past the segment size, the writer turns it into a read-only FChatArchive next to
+ * the log and starts a new, empty segment.
+ */
+class CHATSYSTEM_API FChatJournal : public FRunnable
+{
+public:
+	/** Records between two index checkpoints */
+	static constexpr int64 CheckpointInterval = 256;
+
+	/**
+	 * Open a journal for appending, creating it if needed, and read back its newest messages
+	 * @param Path Log file path; the index is stored next to it with an .idx suffix
+	 * @param MaxMessagesToLoad Number of newest messages to read back
+	 * @param FlushInterval Seconds between background writes
+	 * @param MaxSegmentSize Log size in bytes at which the segment is archived, 0 to never archive
+	 * @param OutRecentMessages Receives up to MaxMessagesToLoad messages of the live segment, oldest first (Sender is always null)
+	 * @return The open journal, or nullptr if the file could not be opened
+	 */
+	static TUniquePtr<FChatJournal> Open(const FString& Path, int32 MaxMessagesToLoad, float FlushInterval, int64 MaxSegmentSize, TArray<FChatMessage>& OutRecentMessages);
+
+	/** Writes everything still queued, then closes the files */
+	virtual ~FChatJournal() override;
+
+	/**
+	 * Queue a message for writing (game thread)
+	 * @param Message The routed message
+	 */
+	void Append(const FChatMessage& Message);
+
+	// FRunnable interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	FChatJournal(const FString& InPath, TUniquePtr<IFileHandle> InLogFile, TUniquePtr<IFileHandle> InIndexFile, int64 InNumRecords, int64 InLogSize, float FlushInterval, int64 InMaxSegmentSize);
+
+	/** Write every queued record and any checkpoints they cross (writer thread) */
+	void WriteQueuedRecords();
+
+	/** Archive the current segment and start an empty one (writer thread) */
+	void RotateSegment();
+
+	FString Path;
+
+	/** Log and index files, only touched by the writer thread once it runs */
+	TUniquePtr<IFileHandle> LogFile;
+	TUniquePtr<IFileHandle> IndexFile;
+
+	/** Encoded records waiting for the writer */
+	TQueue<TArray<uint8>, EQueueMode::Spsc> PendingRecords;
+
+	/** Bytes waiting in PendingRecords; the writer is woken early when this gets large */
+	std::atomic<int64> PendingBytes{0};
+
+	/** Records written to the current segment by the writer thread, and the log size after them */
+	int64 NumRecordsWritten = 0;
+	int64 LogSize = 0;
+
+	/** Segment size limit, 0 to never archive */
+	int64 MaxSegmentSize = 0;
+
+	/** Log size at which the next rotation is attempted; pushed back if archiving fails */
+	int64 RotateAtSize = 0;
+
+	/** Milliseconds the writer sleeps between batches */
+	uint32 FlushIntervalMs = 1000;
+
+	std::atomic<bool> bStopping{false};
+	FEvent* WakeEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+};
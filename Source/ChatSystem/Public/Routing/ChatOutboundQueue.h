@@ -0,0 +1,124 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/ChatMessage.h"
+#include "ChatOutboundQueue.generated.h"
+
+/**
+ * Counters for one recipient's outbound queue
+ */
+USTRUCT(BlueprintType)
+struct CHATSYSTEM_API FChatOutboundStats
+{
+	GENERATED_BODY()
+
+	/** Messages currently waiting */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int32 QueueDepth = 0;
+
+	/** Most messages that were waiting at once */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int32 PeakQueueDepth = 0;
+
+	/** Messages sent from the queue */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 MessagesSent = 0;
+
+	/** Estimated bytes sent from the queue */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	int64 BytesSent = 0;
+
+	/** Messages dropped because they waited longer than their channel's lifetime, per EChatChannel */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	TArray<int64> MessagesExpired;
+
+	/**
+	 * Time sent messages spent queued, in FChatOutboundQueue::NumAgeBuckets buckets:
+	 * under 50ms, 100ms, 250ms, 500ms, 1s, 2s, 5s, and 5s or more
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "Chat")
+	TArray<int64> QueuedAgeHistogram;
+};
+
+/** Messages of one priority waiting to be sent, oldest first */
+USTRUCT()
+struct CHATSYSTEM_API FChatOutboundLane
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FChatMessage> Messages;
+
+	/** FPlatformTime::Seconds() at which each message was queued */
+	TArray<double> QueueTimes;
+
+	/** Entries before this were already sent or dropped and are compacted away lazily */
+	int32 Head = 0;
+
+	int32 Num() const { return Messages.Num() - Head; }
+};
+
+/**
+ * One recipient's outgoing messages, sent highest priority first within a byte budget
+ * Priority follows the channel: System, Whisper, Team, Custom, Proximity, then Global. Each lane is
+ * FIFO, and a message that waits longer than its channel's lifetime is dropped rather than sent late.
+ * The budget refills continuously up to one second's worth; a message is sent whenever any budget is
+ * left, so one large message can overdraw it but never gets stuck.
+ */
+USTRUCT()
+struct CHATSYSTEM_API FChatOutboundQueue
+{
+	GENERATED_BODY()
+
+	/** Buckets in FChatOutboundStats::QueuedAgeHistogram */
+	static constexpr int32 NumAgeBuckets = 8;
+
+	FChatOutboundQueue();
+
+	/**
+	 * Queue a message behind others of the same priority
+	 * @param Message The message
+	 * @param Now FPlatformTime::Seconds()
+	 */
+	void Enqueue(const FChatMessage& Message, double Now);
+
+	/**
+	 * Drop stale messages, then send as many as the budget allows, highest priority first
+	 * @param Now FPlatformTime::Seconds()
+	 * @param Settings Budget and lifetimes to apply
+	 * @param bIgnoreBudget Send everything that has not expired
+	 * @param Send Called with each message to send
+	 * @return Number of messages that left the queue, sent or dropped
+	 */
+	int32 Drain(double Now, const FChatSettings& Settings, bool bIgnoreBudget, TFunctionRef<void(const FChatMessage&)> Send);
+
+	/** Number of messages waiting */
+	int32 Num() const { return Stats.QueueDepth; }
+
+	/** Counters for this recipient */
+	const FChatOutboundStats& GetStats() const { return Stats; }
+
+	/** Lane a channel's messages wait in, 0 being sent first */
+	static int32 GetPriority(EChatChannel Channel);
+
+	/** Estimated wire size of a message: strings dominate, plus a fixed overhead for the remaining fields */
+	static int32 EstimateWireSize(const FChatMessage& Message) { return 32 + Message.SenderName.Len() + Message.Content.Len(); }
+
+private:
+	/** Advance a lane's head, compacting once enough dead entries have built up */
+	static void PopFront(FChatOutboundLane& Lane);
+
+	/** One lane per EChatChannel, in priority order */
+	UPROPERTY()
+	TArray<FChatOutboundLane> Lanes;
+
+	FChatOutboundStats Stats;
+
+	/** Bytes that may still be sent, refilled at OutboundBytesPerSecond */
+	double Budget = 0.0;
+
+	/** Time the budget was last refilled (negative = never, starts full) */
+	double LastRefillTime = -1.0;
+};
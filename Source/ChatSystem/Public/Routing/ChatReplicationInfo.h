@@ -0,0 +1,63 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Data/ChatMessage.h"
+#include "ChatReplicationInfo.generated.h"
+
+/**
+ * Always relevant actor that multicasts Global and System messages to every client at once
+ * The engine serializes a multicast's parameters once and reuses the bits for each connection, where
+ * per-recipient client RPCs serialize the same message again for every player. Relayed messages always
+ * carry SenderName so their encoding doesn't depend on what each connection already knows
+ * Spawned by the server's ChatSubsystem while bUseBroadcastRelay is set. Under Iris the subsystem also
+ * spawns one relay per team, with a connection filter so it only replicates to that team's members
+ */
+UCLASS(NotPlaceable, Transient)
+class CHATSYSTEM_API AChatReplicationInfo : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AChatReplicationInfo();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/**
+	 * Deliver a message to every client's local chat components
+	 * @param Message The message to receive
+	 */
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastReceiveMessage(const FChatMessage& Message);
+
+	/**
+	 * Unreliable counterpart of MulticastReceiveMessage, for channels with an unreliable delivery policy
+	 * @param Message The message to receive
+	 */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastReceiveMessageUnreliable(const FChatMessage& Message);
+
+	/**
+	 * Unreliable multicast of several messages, used for the second copies of UnreliableRedundant channels
+	 * @param Messages The messages to receive
+	 */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastReceiveMessageBatchUnreliable(const TArray<FChatMessage>& Messages);
+
+	/** Team whose members this relay reaches (INDEX_NONE = every client); clients drop messages for other teams */
+	UPROPERTY(Replicated)
+	int32 TeamId = INDEX_NONE;
+
+	/** The Iris connection filter matches the team's current members, so a multicast reaches only them (server only) */
+	bool bTeamFilterApplied = false;
+
+	/** UnreliableRedundant messages already multicast once, multicast again with the next flush (server only) */
+	UPROPERTY(Transient)
+	TArray<FChatMessage> RedundantCopies;
+
+private:
+	/** Hand a message to the chat component of each locally controlled player */
+	void DeliverToLocalPlayers(const FChatMessage& Message) const;
+};
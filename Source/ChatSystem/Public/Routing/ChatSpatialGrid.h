@@ -0,0 +1,98 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UChatComponent;
+
+/**
+ * Uniform 2D hash grid of chat component locations used for proximity routing
+ * Cells are square in the XY plane; height is only considered in the final distance check
+ * The grid is a snapshot and must be rebuilt to pick up pawn movement
+ */
+class CHATSYSTEM_API FChatSpatialGrid
+{
+public:
+	/**
+	 * Remove all entries and set the cell size for the next build
+	 * @param InCellSize Edge length of a cell in cm (typically the proximity radius)
+	 */
+	void Reset(float InCellSize);
+
+	/**
+	 * Insert a component at a location
+	 * @param Component The component to insert
+	 * @param Location The world location of the component's pawn
+	 */
+	void Add(UChatComponent* Component, const FVector& Location);
+
+	/** Number of components in the grid */
+	int32 Num() const { return NumEntries; }
+
+	/**
+	 * Visit every component within Radius of Center
+	 * Only the cells overlapping the query circle are examined
+	 * @param Center The query origin
+	 * @param Radius The query radius in cm
+	 * @param Visitor Called with each matching component
+	 */
+	template<typename VisitorType>
+	void ForEachInRadius(const FVector& Center, float Radius, VisitorType&& Visitor) const
+	{
+		if (NumEntries == 0)
+		{
+			return;
+		}
+
+		const FIntPoint MinCell = GetCell(Center - FVector(Radius, Radius, 0.0f));
+		const FIntPoint MaxCell = GetCell(Center + FVector(Radius, Radius, 0.0f));
+		const float RadiusSquared = Radius * Radius;
+
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+			{
+				const TArray<FEntry>* Entries = Cells.Find(FIntPoint(X, Y));
+				if (!Entries)
+				{
+					continue;
+				}
+
+				for (const FEntry& Entry : *Entries)
+				{
+					if (FVector::DistSquared(Center, Entry.Location) <= RadiusSquared)
+					{
+						if (UChatComponent* Component = Entry.Component.Get())
+						{
+							Visitor(Component);
+						}
+					}
+				}
+			}
+		}
+	}
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<UChatComponent> Component;
+		FVector Location;
+	};
+
+	/** Get the cell containing a location */
+	FIntPoint GetCell(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X * InvCellSize), FMath::FloorToInt(Location.Y * InvCellSize));
+	}
+
+	/** Entries bucketed by cell; cell arrays are kept between builds to avoid reallocating */
+	TMap<FIntPoint, TArray<FEntry>> Cells;
+
+	/** 1 / cell size */
+	float InvCellSize = 1.0f / 1000.0f;
+
+	/** Number of entries across all cells */
+	int32 NumEntries = 0;
+};